@@ -0,0 +1,430 @@
+// c-primes-analytics.cpp
+// Fused prime analytics in one sieve pass: pi(x), theta(x) = sum log p,
+// sum 1/p and prime counts by residue mod q (any q dividing 840), with
+// floating sums that are bitwise identical for any thread count
+// Compile: g++ -O3 -march=native -pthread -std=c++17 c-primes-analytics.cpp -o c-primes-analytics
+// Usage:   c-primes-analytics [x]   (default 1e10, up to 2^50)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using u64 = uint64_t;
+using u32 = uint32_t;
+using i64 = int64_t;
+
+inline int ctz64(u64 x) { return __builtin_ctzll(x); }
+
+// ============================================================================
+// Base sieve
+// ============================================================================
+std::vector<u32> base_sieve(u32 n) {
+    u32 h = n / 2 + 1;
+    std::vector<u64> b((h + 63) >> 6, ~0ULL);
+    b[0] ^= 1;
+    for (u32 i = 1, L = (u32)std::sqrt(n) / 2; i <= L; ++i)
+        if (b[i >> 6] >> (i & 63) & 1)
+            for (u32 j = 2*i*(i+1), s = 2*i+1; j < h; j += s)
+                b[j >> 6] &= ~(1ULL << (j & 63));
+    std::vector<u32> P{2};
+    for (u32 i = 0; i < b.size(); ++i)
+        for (auto w = b[i]; w; w &= w - 1) {
+            u32 v = ((i << 6) + ctz64(w)) * 2 + 1;
+            if (v > 1 && v <= n) P.push_back(v);
+        }
+    return P;
+}
+
+u64 isqrt(u64 n) {
+    u64 r = (u64)std::sqrt((double)n);
+    while (r * r > n) --r;
+    while ((r + 1) * (r + 1) <= n) ++r;
+    return r;
+}
+
+// ============================================================================
+// Segment sieve: odd-only, presieved, offsets carried across segments
+// ============================================================================
+constexpr u32 S = 1 << 18;                  // 256K odds per segment (32KB)
+constexpr u64 BLOCK = 1ULL << 27;           // numbers per work item / partial sum
+
+// Odd n = 2k + 1 is a multiple of q exactly when k = (q - 1) / 2 (mod q), so
+// the primes 3..13 repeat with period 15015 in k
+constexpr u32 PRE_L = 3 * 5 * 7 * 11 * 13;
+constexpr size_t PRE_PRIMES = 6;            // B[0..5] = 2, 3, 5, 7, 11, 13
+
+const std::vector<u64>& presieve_pattern() {
+    static const std::vector<u64> ext = [] {
+        std::vector<u64> v((PRE_L + 128 + 63) / 64, 0);
+        for (u32 j = 0; j < PRE_L + 128; ++j) {
+            u32 k = j % PRE_L;
+            bool keep = true;
+            for (u32 q : {3, 5, 7, 11, 13})
+                if (k % q == (q - 1) / 2) keep = false;
+            if (keep) v[j >> 6] |= 1ULL << (j & 63);
+        }
+        return v;
+    }();
+    return ext;
+}
+
+inline void presieve_fill(u64* __restrict seg, u32 words, u64 k0) {
+    const u64* ext = presieve_pattern().data();
+    u32 t = (u32)(k0 % PRE_L);
+    for (u32 i = 0; i < words; ++i) {
+        u32 w = t >> 6, sh = t & 63;
+        seg[i] = sh ? (ext[w] >> sh) | (ext[w + 1] << (64 - sh)) : ext[w];
+        t += 64;
+        if (t >= PRE_L) t -= PRE_L;
+    }
+}
+
+struct SegmentSieve {
+    const std::vector<u32>& B;
+    std::vector<u64> off;
+    std::vector<u64> seg_buf;
+
+    explicit SegmentSieve(const std::vector<u32>& B_) : B(B_), off(B_.size()), seg_buf(S / 64) {}
+
+    // Odd primes in [lo, hi): consume(seg, words, o) per segment, bit i <-> o + 2i
+    template <class F>
+    void run(u64 lo, u64 hi, F&& consume) {
+        u64 o = std::max<u64>(lo, 3) | 1;
+        if (o >= hi) return;
+        u64 n_odds = (hi - o + 1) >> 1;
+
+        size_t np = PRE_PRIMES;
+        for (; np < B.size(); ++np) {
+            u64 p = B[np];
+            if (p * p >= hi) break;
+            u64 start = p * p;
+            if (start < o) {
+                start = ((o + p - 1) / p) * p;
+                if (!(start & 1)) start += p;
+            }
+            off[np] = (start - o) >> 1;
+        }
+
+        u64* seg = seg_buf.data();
+        for (u64 base = 0; base < n_odds; base += S) {
+            u32 len = (u32)std::min<u64>(S, n_odds - base);
+            u32 words = (len + 63) >> 6;
+            presieve_fill(seg, words, ((o - 1) >> 1) + base);
+            if (base == 0)                          // the pattern struck 3..13 themselves
+                for (u64 q : {3, 5, 7, 11, 13})
+                    if (q >= o && q < hi) seg[(q - o) >> 7] |= 1ULL << (((q - o) >> 1) & 63);
+            for (size_t i = PRE_PRIMES; i < np; ++i) {
+                u64 p = B[i], idx = off[i];
+                if (p < 64) {
+                    while (idx + 4 * p <= len) {
+                        seg[idx >> 6] &= ~(1ULL << (idx & 63)); idx += p;
+                        seg[idx >> 6] &= ~(1ULL << (idx & 63)); idx += p;
+                        seg[idx >> 6] &= ~(1ULL << (idx & 63)); idx += p;
+                        seg[idx >> 6] &= ~(1ULL << (idx & 63)); idx += p;
+                    }
+                }
+                while (idx < len) {
+                    seg[idx >> 6] &= ~(1ULL << (idx & 63));
+                    idx += p;
+                }
+                off[i] = idx - len;
+            }
+            if (len & 63) seg[words - 1] &= (1ULL << (len & 63)) - 1;
+            consume(seg, words, o + 2 * base);
+        }
+    }
+};
+
+// ============================================================================
+// Reproducible accumulators
+// ============================================================================
+// theta is kept as a product: eight lane products of p, renormalised to
+// [1, 2) every 16 steps with the exponents summed exactly in integers, so
+// theta = E ln 2 + log(M) needs one log at the very end and each prime costs
+// a single rounding (2^-53 relative) instead of a log and an addition. 1/p
+// goes into eight Kahan lanes. Lane assignment depends only on a prime's
+// position within its segment and segments only on the fixed BLOCK grid, so
+// a block's partial is the same whichever thread runs it; partials are then
+// merged in block order.
+constexpr u32 LANES = 8;
+constexpr u32 NORM_EVERY = 16;              // 16 factors < 2^52 stay below 2^1023
+constexpr u32 MOD_L = 840;                  // 8 * 3 * 5 * 7: residues for q | 840
+
+inline i64 split_exp(double& m) {           // m = 2^e * m', m' in [1, 2)
+    u64 b;
+    std::memcpy(&b, &m, 8);
+    i64 e = (i64)((b >> 52) & 0x7FF) - 1023;
+    b = (b & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL;
+    std::memcpy(&m, &b, 8);
+    return e;
+}
+
+struct Neumaier {
+    double s = 0, c = 0;
+    void add(double x) {
+        double t = s + x;
+        c += std::fabs(s) >= std::fabs(x) ? (s - t) + x : (x - t) + s;
+        s = t;
+    }
+    double value() const { return s + c; }
+};
+
+struct Partial {
+    u64 count = 0;
+    double mant = 1;                        // theta = exp2 * ln 2 + log(mant)
+    i64 exp2 = 0;
+    Neumaier recip;
+
+    void merge(const Partial& o) {
+        count += o.count;
+        mant *= o.mant;
+        exp2 += o.exp2 + split_exp(mant);
+        recip.add(o.recip.s);
+        recip.add(o.recip.c);
+    }
+};
+
+// Padded entries are 1.0: a neutral factor, and masked out of the 1/p sum
+static void accumulate(const double* __restrict v, u32 n, double* __restrict prod,
+                       double* __restrict ks, double* __restrict kc, i64* __restrict ke, u32& since) {
+    for (u32 j = 0; j < n; j += LANES) {
+        for (u32 l = 0; l < LANES; ++l) {
+            double p = v[j + l];
+            prod[l] *= p;
+            double r = p > 1.0 ? 1.0 / p : 0.0;
+            double y = r - kc[l];
+            double t = ks[l] + y;
+            kc[l] = (t - ks[l]) - y;
+            ks[l] = t;
+        }
+        if (++since == NORM_EVERY) {
+            since = 0;
+            for (u32 l = 0; l < LANES; ++l) {
+                u64 b;
+                std::memcpy(&b, &prod[l], 8);
+                ke[l] += (i64)((b >> 52) & 0x7FF) - 1023;
+                b = (b & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL;
+                std::memcpy(&prod[l], &b, 8);
+            }
+        }
+    }
+}
+
+struct BlockAccumulator {
+    alignas(64) double prod[LANES], ks[LANES], kc[LANES];
+    alignas(64) i64 ke[LANES];
+    u32 since = 0;
+    u64 count = 0;
+    std::vector<double> buf = std::vector<double>(S + LANES);
+    u64* hist;                              // per-thread, integer so order-free
+
+    explicit BlockAccumulator(u64* hist_) : hist(hist_) { reset(); }
+
+    void reset() {
+        for (u32 l = 0; l < LANES; ++l) { prod[l] = 1; ks[l] = kc[l] = 0; ke[l] = 0; }
+        since = 0;
+        count = 0;
+    }
+
+    void add_two() {
+        prod[0] *= 2;
+        ks[0] += 0.5;
+        ++count;
+        ++hist[2];
+    }
+
+    // Extraction: primes of one segment into buf, residues into the histogram
+    void consume(const u64* seg, u32 words, u64 o) {
+        u32 n = 0, r0 = (u32)(o % MOD_L);
+        double od = (double)o;
+        for (u32 w = 0; w < words; ++w)
+            for (u64 b = seg[w]; b; b &= b - 1) {
+                u32 i = (w << 6) + ctz64(b);
+                buf[n++] = od + 2.0 * i;
+                ++hist[(r0 + 2 * i) % MOD_L];
+            }
+        count += n;
+        while (n % LANES) buf[n++] = 1.0;
+        accumulate(buf.data(), n, prod, ks, kc, ke, since);
+    }
+
+    Partial finish() const {
+        Partial r;
+        r.count = count;
+        for (u32 l = 0; l < LANES; ++l) {
+            double m = prod[l];
+            r.exp2 += ke[l] + split_exp(m);
+            r.mant *= m;
+            r.exp2 += split_exp(r.mant);
+            r.recip.add(ks[l]);
+            r.recip.add(-kc[l]);
+        }
+        return r;
+    }
+};
+
+// ============================================================================
+// Driver
+// ============================================================================
+struct Analytics {
+    u64 x = 0, count = 0;
+    double theta = 0, theta_gap = 0;        // theta(x), x - theta(x)
+    double recip = 0;                       // sum 1/p
+    std::vector<u64> hist = std::vector<u64>(MOD_L, 0);
+    Partial raw;                            // for bitwise comparison
+};
+
+constexpr double LN2_HI = 0.6931471805599453;
+constexpr double LN2_LO = 2.3190468138462996e-17;
+
+Analytics analyze(u64 x, u32 num_threads) {
+    auto B = base_sieve((u32)isqrt(x) + 1);
+    u64 blocks = x / BLOCK + 1;
+    std::vector<Partial> part(blocks);
+    std::vector<std::vector<u64>> hists(num_threads, std::vector<u64>(MOD_L, 0));
+    std::atomic<u64> next{0};
+    auto worker = [&](u32 t) {
+        SegmentSieve sv(B);
+        BlockAccumulator acc(hists[t].data());
+        for (u64 b; (b = next.fetch_add(1)) < blocks; ) {
+            u64 lo = b * BLOCK, hi = std::min(lo + BLOCK, x + 1);
+            acc.reset();
+            if (lo <= 2 && 2 < hi) acc.add_two();
+            sv.run(lo, hi, [&](const u64* seg, u32 words, u64 o) { acc.consume(seg, words, o); });
+            part[b] = acc.finish();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (u32 i = 0; i < num_threads; ++i)
+        threads.emplace_back(worker, i);
+    for (auto& t : threads)
+        t.join();
+
+    Analytics a;
+    a.x = x;
+    for (const Partial& p : part) a.raw.merge(p);
+    for (auto& h : hists)
+        for (u32 r = 0; r < MOD_L; ++r) a.hist[r] += h[r];
+    a.count = a.raw.count;
+    a.recip = a.raw.recip.value();
+    // E ln 2 as a double-double (E < 2^52 is exact), then add log(M)
+    double E = (double)a.raw.exp2;
+    double hi = E * LN2_HI;
+    double lo = std::fma(E, LN2_HI, -hi) + E * LN2_LO + std::log(a.raw.mant);
+    a.theta = hi + lo;
+    a.theta_gap = ((double)x - hi) - lo;
+    return a;
+}
+
+// Counting-only pass over the same sieve, for the throughput comparison
+u64 count_only(u64 x, u32 num_threads) {
+    auto B = base_sieve((u32)isqrt(x) + 1);
+    u64 blocks = x / BLOCK + 1;
+    std::atomic<u64> next{0}, total{x >= 2 ? 1u : 0u};
+    auto worker = [&]() {
+        SegmentSieve sv(B);
+        u64 cnt = 0;
+        for (u64 b; (b = next.fetch_add(1)) < blocks; )
+            sv.run(b * BLOCK, std::min(b * BLOCK + BLOCK, x + 1), [&](const u64* seg, u32 words, u64) {
+                for (u32 i = 0; i < words; ++i) cnt += __builtin_popcountll(seg[i]);
+            });
+        total += cnt;
+    };
+    std::vector<std::thread> threads;
+    for (u32 i = 0; i < num_threads; ++i)
+        threads.emplace_back(worker);
+    for (auto& t : threads)
+        t.join();
+    return total;
+}
+
+// Residue counts mod q for q | 840, folded from the mod-840 histogram
+std::vector<u64> fold(const std::vector<u64>& h, u32 q) {
+    std::vector<u64> r(q, 0);
+    for (u32 i = 0; i < MOD_L; ++i) r[i % q] += h[i];
+    return r;
+}
+
+u64 parse_u64(const char* s) {
+    return std::strpbrk(s, "eE.") ? (u64)std::strtod(s, nullptr) : std::strtoull(s, nullptr, 10);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    using namespace std::chrono;
+
+    u64 x = argc > 1 ? parse_u64(argv[1]) : 10'000'000'000ULL;
+    if (x < 100 || x > (1ULL << 50)) { std::cerr << "need 100 <= x <= 2^50\n"; return 1; }
+    u32 num_threads = std::thread::hardware_concurrency();
+    if (num_threads == 0) num_threads = 4;
+
+    std::cout << "=== Fused Prime Analytics to " << x << " ===\n";
+    std::cout << "Threads: " << num_threads << ", block 2^27, " << LANES << " lanes\n\n";
+
+    auto t0 = high_resolution_clock::now();
+    u64 pi_count = count_only(x, num_threads);
+    auto t1 = high_resolution_clock::now();
+    Analytics a = analyze(x, num_threads);
+    auto t2 = high_resolution_clock::now();
+
+    // Reproducibility: same partials from 1 and 7 threads at a smaller bound
+    u64 xr = std::min<u64>(x, 2'000'000'000ULL);
+    Analytics r1 = analyze(xr, 1), r7 = analyze(xr, 7);
+    bool repro = r1.raw.count == r7.raw.count && r1.raw.exp2 == r7.raw.exp2 &&
+                 !std::memcmp(&r1.raw.mant, &r7.raw.mant, 8) && !std::memcmp(&r1.raw.recip, &r7.raw.recip, 16) &&
+                 r1.hist == r7.hist;
+
+    // Accuracy: straight long double sums over a plain sieve
+    const u32 xs = 100'000'000;
+    Analytics s = analyze(xs, num_threads);
+    long double ref_theta = 0, ref_recip = 0;
+    std::vector<u64> ref_hist(MOD_L, 0);
+    auto P = base_sieve(xs);
+    for (u32 p : P) {
+        ref_theta += std::log((long double)p);
+        ref_recip += 1.0L / p;
+        ++ref_hist[p % MOD_L];
+    }
+    double err_theta = std::fabs((double)(s.theta - ref_theta));
+    double err_recip = std::fabs((double)(s.recip - ref_recip));
+    bool accurate = s.count == P.size() && s.hist == ref_hist && err_theta < 1e-6 && err_recip < 1e-12;
+    auto t4 = high_resolution_clock::now();
+
+    double count_s = duration<double>(t1 - t0).count(), fused_s = duration<double>(t2 - t1).count();
+    std::cout << "Count only:     " << (u64)(count_s * 1000) << " ms\n";
+    std::cout << "Fused pass:     " << (u64)(fused_s * 1000) << " ms (" << std::setprecision(3)
+              << fused_s / count_s << "x counting)\n";
+    std::cout << "Checks:         " << duration_cast<milliseconds>(t4 - t2).count() << " ms\n";
+    std::cout << "────────────────────────\n";
+    std::cout << std::setprecision(17);
+    std::cout << "pi(x)           = " << a.count << "\n";
+    std::cout << "theta(x)        = " << std::fixed << std::setprecision(6) << a.theta << "\n";
+    std::cout << "x - theta(x)    = " << a.theta_gap << "\n";
+    std::cout << "sum 1/p         = " << std::setprecision(15) << a.recip << "\n";
+    std::cout << "  - ln ln x     = " << a.recip - std::log(std::log((double)x)) << "  (Meissel-Mertens 0.261497212847643)\n";
+    std::cout.unsetf(std::ios::floatfield);
+    for (u32 q : {3, 4, 8, 10, 12}) {
+        auto h = fold(a.hist, q);
+        std::cout << "mod " << std::setw(2) << q << ":";
+        for (u32 r = 0; r < q; ++r)
+            if (std::gcd(r, q) == 1) std::cout << "  " << r << ": " << h[r];
+        std::cout << "\n";
+    }
+    std::cout << "Verify: pi " << (a.count == pi_count ? "OK" : "MISMATCH")
+              << ", reproducible 1 vs 7 threads to " << xr << " " << (repro ? "OK" : "MISMATCH")
+              << ", vs long double sums to 1e8 " << (accurate ? "OK" : "MISMATCH") << " (theta err "
+              << std::setprecision(3) << err_theta << ", 1/p err " << err_recip << ")\n";
+    std::cout << "\nFused throughput: " << (u64)(x / fused_s / 1e6) << " million/sec\n";
+    return a.count == pi_count && repro && accurate ? 0 : 1;
+}
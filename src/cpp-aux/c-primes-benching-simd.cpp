@@ -6,14 +6,31 @@
 #include <algorithm>
 #include <thread>
 #include <atomic>
+#include <cstring>
+#include <string>
 #include <immintrin.h>
+#if defined(_MSC_VER)
 #include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
 
 using namespace std;
 using namespace std::chrono;
 
+// AVX2 code is compiled in regardless of build flags and only run after
+// has_avx2() says so
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
 // Platform detection and bit scan functions
-#ifdef _WIN64
+#if defined(__GNUC__) || defined(__clang__)
+    inline int ctz32(uint32_t x) { return __builtin_ctz(x); }
+    inline int ctz64(uint64_t x) { return __builtin_ctzll(x); }
+#elif defined(_WIN64)
     // 64-bit Windows
     inline int ctz32(uint32_t x) {
         unsigned long index;
@@ -46,16 +63,34 @@ using namespace std::chrono;
 #endif
 
 // CPU feature detection
+#if defined(_MSC_VER)
+inline void cpuid_ex(int out[4], int leaf, int sub) { __cpuidex(out, leaf, sub); }
+inline uint64_t xgetbv0() { return _xgetbv(0); }
+#else
+inline void cpuid_ex(int out[4], int leaf, int sub) {
+    unsigned a, b, c, d;
+    __cpuid_count(leaf, sub, a, b, c, d);
+    out[0] = (int)a; out[1] = (int)b; out[2] = (int)c; out[3] = (int)d;
+}
+inline uint64_t xgetbv0() {
+    uint32_t lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((uint64_t)hi << 32) | lo;
+}
+#endif
+
 bool has_avx2() {
     int cpuInfo[4];
-    __cpuid(cpuInfo, 0);
+    cpuid_ex(cpuInfo, 0, 0);
     int nIds = cpuInfo[0];
+    if (nIds < 7) return false;
     
-    if (nIds >= 7) {
-        __cpuidex(cpuInfo, 7, 0);
-        return (cpuInfo[1] & (1 << 5)) != 0;  // AVX2 is EBX bit 5
-    }
-    return false;
+    // The OS must save YMM state (OSXSAVE, then XCR0 bits 1-2)
+    cpuid_ex(cpuInfo, 1, 0);
+    if (!(cpuInfo[2] & (1 << 27)) || (xgetbv0() & 0x6) != 0x6) return false;
+    
+    cpuid_ex(cpuInfo, 7, 0);
+    return (cpuInfo[1] & (1 << 5)) != 0;  // AVX2 is EBX bit 5
 }
 
 // Original baseline implementation
@@ -307,15 +342,14 @@ public:
     }
 };
 
-// AVX2 optimized version (only if AVX2 is available)
-#ifdef __AVX2__
+// AVX2 optimized version (only run if has_avx2())
 class AVX2Sieve {
 private:
     alignas(32) vector<uint64_t> bits;
     int size;
     
 public:
-    vector<int> sieve(int n) {
+    TARGET_AVX2 vector<int> sieve(int n) {
         if (n < 2) return {};
         
         size = n;
@@ -356,10 +390,13 @@ public:
         return primes;
     }
 };
-#endif
 
-// Benchmark function
+// Benchmark function; with --only=NAME, every other name is skipped
+static const char* g_only = nullptr;
+
 void benchmark(const string& name, function<vector<int>(int)> func, int n) {
+    if (g_only && name != g_only) return;
+    
     // Warm up
     func(1000);
     
@@ -380,16 +417,22 @@ void benchmark(const string& name, function<vector<int>(int)> func, int n) {
          << "found " << result.size() << " primes" << endl;
 }
 
-int main() {
+// Usage: c-primes-benching-simd [--only=Original|Bit-packed|Segmented|Parallel|AVX2]
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++)
+        if (strncmp(argv[i], "--only=", 7) == 0) g_only = argv[i] + 7;
+    
     cout << "Prime Sieve Optimizations Benchmark" << endl;
     cout << "====================================" << endl;
     
     // System info
     cout << "\nSystem Information:" << endl;
-#ifdef _WIN64
+#if defined(_WIN64)
     cout << "Platform: Windows x64 (64-bit)" << endl;
-#else
+#elif defined(_WIN32)
     cout << "Platform: Windows x86 (32-bit)" << endl;
+#else
+    cout << "Platform: " << (sizeof(void*) * 8) << "-bit" << endl;
 #endif
     cout << "Hardware threads: " << thread::hardware_concurrency() << endl;
     cout << "AVX2 support: " << (has_avx2() ? "YES" : "NO") << endl;
@@ -410,12 +453,10 @@ int main() {
     ParallelSieve par;
     benchmark("Parallel", [&par](int n) { return par.sieve(n); }, n);
     
-#ifdef __AVX2__
     if (has_avx2()) {
         AVX2Sieve avx2;
         benchmark("AVX2", [&avx2](int n) { return avx2.sieve(n); }, n);
     }
-#endif
     
     // Test with larger value
     n = 10000000;
@@ -0,0 +1,516 @@
+// c-primes-bulk-filter.cpp
+// Density-adaptive bulk primality filter for arrays of u64 candidates:
+// cluster by value cell, sieve the cells where that beats per-value tests
+// and Miller-Rabin the rest; mask comes back in input order
+// Compile: g++ -O3 -march=native -pthread -std=c++17 c-primes-bulk-filter.cpp -o c-primes-bulk-filter
+// Usage:   c-primes-bulk-filter [count]   (default 4000000 candidates per batch)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using u64 = uint64_t;
+using u32 = uint32_t;
+using u8 = uint8_t;
+using u128 = unsigned __int128;
+
+inline int ctz64(u64 x) { return __builtin_ctzll(x); }
+
+// ============================================================================
+// Base sieve
+// ============================================================================
+std::vector<u32> base_sieve(u32 n) {
+    u32 h = n / 2 + 1;
+    std::vector<u64> b((h + 63) >> 6, ~0ULL);
+    b[0] ^= 1;
+    for (u32 i = 1, L = (u32)std::sqrt(n) / 2; i <= L; ++i)
+        if (b[i >> 6] >> (i & 63) & 1)
+            for (u32 j = 2*i*(i+1), s = 2*i+1; j < h; j += s)
+                b[j >> 6] &= ~(1ULL << (j & 63));
+    std::vector<u32> P{2};
+    for (u32 i = 0; i < b.size(); ++i)
+        for (auto w = b[i]; w; w &= w - 1) {
+            u32 v = ((i << 6) + ctz64(w)) * 2 + 1;
+            if (v > 1 && v <= n) P.push_back(v);
+        }
+    return P;
+}
+
+u64 isqrt(u64 n) {
+    u64 r = (u64)std::sqrt((double)n);
+    while (r > 0xFFFFFFFFULL || r * r > n) --r;
+    while (r < 0xFFFFFFFFULL && (r + 1) * (r + 1) <= n) ++r;
+    return r;
+}
+
+// ============================================================================
+// Miller-Rabin (deterministic for all u64)
+// ============================================================================
+// Montgomery over the full odd u64 range: REDC subtracts high halves instead
+// of adding m*n, so nothing overflows when n >= 2^63.
+struct MontFull {
+    u64 n, ninv, one, r2;
+    explicit MontFull(u64 n_) : n(n_) {
+        u64 inv = n;
+        for (int i = 0; i < 5; ++i) inv *= 2 - n * inv;
+        ninv = inv;
+        one = (0 - n) % n;
+        r2 = (u64)((u128)one * one % n);
+    }
+    u64 redc(u128 t) const {
+        u64 m = (u64)t * ninv;
+        u64 th = (u64)(t >> 64), mh = (u64)(((u128)m * n) >> 64);
+        return th >= mh ? th - mh : th - mh + n;
+    }
+    u64 mul(u64 a, u64 b) const { return redc((u128)a * b); }
+    u64 to(u64 a) const { return mul(a % n, r2); }
+};
+
+bool mr_witness(const MontFull& m, u64 a, u64 d, int s) {
+    u64 x = m.one, b = m.to(a);
+    if (b == 0) return false;
+    for (u64 e = d; e; e >>= 1) {
+        if (e & 1) x = m.mul(x, b);
+        b = m.mul(b, b);
+    }
+    u64 neg = m.n - m.one;
+    if (x == m.one || x == neg) return false;
+    for (int i = 1; i < s; ++i) {
+        x = m.mul(x, x);
+        if (x == neg) return false;
+        if (x == m.one) return true;
+    }
+    return true;
+}
+
+constexpr u32 TRIAL_PRIMES[] = {3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61, 67, 71};
+
+bool is_prime_mr(u64 n) {
+    if (n < 2) return false;
+    if (!(n & 1)) return n == 2;
+    for (u32 p : TRIAL_PRIMES) {
+        if (n == p) return true;
+        if (n % p == 0) return false;
+    }
+    if (n < 73 * 73) return true;
+    u64 d = n - 1;
+    int s = ctz64(d);
+    d >>= s;
+    MontFull m(n);
+    if (n < (1ULL << 32)) {
+        for (u64 a : {2, 7, 61})
+            if (mr_witness(m, a, d, s)) return false;
+        return true;
+    }
+    for (u64 a : {2ULL, 325ULL, 9375ULL, 28178ULL, 450775ULL, 9780504ULL, 1795265022ULL})
+        if (a % n && mr_witness(m, a, d, s)) return false;
+    return true;
+}
+
+// ============================================================================
+// Bulk filter
+// ============================================================================
+// Candidates are clustered by 2^21-wide value cells rather than sorted (a
+// radix sort of millions of (value, index) pairs cost more than the MR work it
+// saved). Cells are chosen on a 1-in-SAMPLE_STRIDE sample, read as short
+// contiguous runs so it touches only that share of the batch's cache lines:
+// a hashed table of saturating bytes counts sampled occupancy, members of
+// buckets too thin to pay a cell's base-prime offsets are dropped, and the
+// rest are ranked by cell. Each sampled cell is costed both ways with its
+// count scaled up: sieving its window against MR on every member. The window
+// is the sampled [min, max] padded by two mean sample gaps at each end;
+// members that still fall outside it go to MR, so the sample only steers
+// cost, never results. Sampling can err either way: a cell near break-even
+// may land on the more expensive side, and a dense cell the sample misses is
+// left to MR.
+//
+// Nothing is grouped by index. Execution sieves every window into its own
+// bitmap (at most 128KB each; a window only pays with >~30k members, so this
+// stays within a few bytes per candidate), then walks the batch in input
+// order: one lookup in the small cell map, a bitmap read inside a window and
+// MR otherwise. SieveOnly ranks every value to get exact spans instead.
+//
+// Window cost: per number (the L1 sweeps of primes < SUB_ODDS), per crossing
+// of a larger prime (~0.5 ln(ln bound / ln SUB_ODDS) per number, random RMWs
+// in L2), one offset per base prime, a bitmap read per member, and a full MR
+// on survivors when sqrt(max) is above the prime cap (~0.56 / ln bound of
+// the members, nearly all of them prime). MR on a plain candidate averages
+// over the evens and trial-division rejects. Constants are ns, fitted on the
+// dev box to plan + execute over single-cell and uniform b-bit batches.
+constexpr double C_SIEVE = 1.5;         // per number in a sieved window
+constexpr double C_HIT = 7.5;           // per crossing by a prime >= SUB_ODDS
+constexpr double C_OFFSET = 6.0;        // per base prime per window (division + loop)
+constexpr double C_MEMBER = 9.0;        // per member read back from the bitmap
+constexpr double C_WITNESS_BIT = 5.8;   // per MR witness per bit of a prime
+constexpr double C_MR_SMALL = 80.0;     // per MR candidate < 2^32 (3 witnesses)
+constexpr double C_MR_BASE = 100.0;     // per MR candidate >= 2^32: base + per bit
+constexpr double C_MR_BIT = 0.9;
+constexpr u32 CELL_BITS = 21;           // window granularity (128KB odd bitmap)
+constexpr u32 HASH_BITS_MIN = 16;       // occupancy table: ~n/4 saturating
+constexpr u32 HASH_BITS_MAX = 22;       // u8 counters, 64KB..4MB
+constexpr u32 T_MIN = 32;               // floor on the members a cell needs
+constexpr u32 SUB_ODDS = 1u << 18;      // L1 block inside a window (32KB)
+constexpr u32 PRIME_CAP = 1u << 24;     // base primes kept for windows (1.08M)
+constexpr u32 ITEM_VALUES = 4096;       // values per read-back/MR work item
+constexpr u32 SAMPLE_STRIDE = 16;       // cells are chosen on 1 value in 16,
+constexpr u32 SAMPLE_RUN = 64;          // taken as runs of 64 (512B) per 1024
+
+enum class Strategy { Adaptive, SieveOnly, MROnly };
+
+struct FilterStats {
+    bool sampled_out = false;           // no sampled cell was worth sieving
+    u64 cells = 0;                      // candidate cells: bucket full enough to cost
+    u64 sieved_cells = 0, window_numbers = 0;
+    u64 sieved_values = 0, mr_values = 0;   // filled in by execute
+};
+
+inline u64 mix64(u64 c) { c *= 0x9E3779B97F4A7C15ULL; return c ^ (c >> 29); }
+
+// Open-addressed cell -> rank map, grown at half load
+struct CellMap {
+    struct Slot { u64 key; u32 val; };
+    std::vector<Slot> slot = std::vector<Slot>(1024, Slot{UINT64_MAX, 0});
+    u32 size = 0;
+    u32 rank(u64 c) {
+        size_t m = slot.size() - 1, h = mix64(c) & m;
+        while (slot[h].key != c && slot[h].key != UINT64_MAX) h = (h + 1) & m;
+        if (slot[h].key == c) return slot[h].val;
+        if (2 * (size + 1) > slot.size()) {
+            grow();
+            return rank(c);
+        }
+        slot[h] = {c, size};
+        return size++;
+    }
+    // Rank of c, or UINT32_MAX if absent
+    u32 find(u64 c) const {
+        size_t m = slot.size() - 1, h = mix64(c) & m;
+        while (slot[h].key != c && slot[h].key != UINT64_MAX) h = (h + 1) & m;
+        return slot[h].key == c ? slot[h].val : UINT32_MAX;
+    }
+    void grow() {
+        std::vector<Slot> s(slot.size() * 2, Slot{UINT64_MAX, 0});
+        for (const Slot& e : slot)
+            if (e.key != UINT64_MAX) {
+                size_t m = s.size() - 1, h = mix64(e.key) & m;
+                while (s[h].key != UINT64_MAX) h = (h + 1) & m;
+                s[h] = e;
+            }
+        slot.swap(s);
+    }
+};
+
+struct BulkFilter {
+    std::vector<u32> B = base_sieve(PRIME_CAP);
+    u8 min_count[65];                   // per bit length: members a cell needs to pay its offsets
+    double mr_ns[65];                   // per bit length: MR cost of one candidate
+
+    BulkFilter() {
+        for (u32 bits = 0; bits <= 64; ++bits) {
+            mr_ns[bits] = bits <= 32 ? C_MR_SMALL : C_MR_BASE + C_MR_BIT * bits;
+            u64 lo = bits ? 1ULL << (bits - 1) : 0;
+            u64 bound = std::min<u64>(isqrt(lo), PRIME_CAP);
+            double np = (double)(std::upper_bound(B.begin(), B.end(), (u32)bound) - B.begin());
+            min_count[bits] = (u8)std::clamp(np * C_OFFSET / mr_ns[bits], (double)T_MIN, 255.0);
+        }
+    }
+
+    static u32 bit_length(u64 x) { return 64 - __builtin_clzll(x | 1); }
+
+    // A sieved window [lo, hi] and its bitmap at word offset `word`; values
+    // from `proven` up still need MR when their bit survives
+    struct Window { u64 lo, hi, proven; size_t word; };
+    struct Plan {
+        CellMap cells;                  // cell -> window index
+        std::vector<Window> win;        // + a trailing empty window for misses
+        size_t words = 0;               // bitmap words over all windows
+        FilterStats stats;
+        double est_ms = 0;              // cost model total
+    };
+
+    double window_cost(u64 lo, u64 hi, u64 k) const {
+        u64 bound = std::min<u64>(isqrt(hi), PRIME_CAP);
+        double np = (double)(std::upper_bound(B.begin(), B.end(), (u32)bound) - B.begin());
+        double hits = bound > SUB_ODDS ? 0.5 * std::log(std::log((double)bound) / std::log((double)SUB_ODDS)) : 0;
+        double survivors = (bound + 1) * (bound + 1) <= hi ? k * 0.56 / std::log((double)bound) : 0;
+        double prime_mr = 7 * bit_length(hi) * C_WITNESS_BIT;
+        return (double)(hi - lo + 1) * (C_SIEVE + hits * C_HIT) + np * C_OFFSET + k * C_MEMBER
+               + survivors * prime_mr;
+    }
+
+    double mr_cost(u64 x, u64 k) const { return k * mr_ns[bit_length(x)]; }
+
+    struct Cell { u64 cnt, mn, mx; };
+
+    // The first SAMPLE_RUN values of every SAMPLE_RUN * stride; stride 1
+    // visits them all
+    template <class F>
+    static void for_sample(const std::vector<u64>& v, size_t stride, F f) {
+        for (size_t b = 0; b < v.size(); b += SAMPLE_RUN * stride)
+            for (size_t i = b, e = std::min(v.size(), b + SAMPLE_RUN); i < e; ++i) f(v[i]);
+    }
+
+    // Sampled cells whose bucket reaches min_count / stride sampled members
+    // (1 if sieve_all), ranked in cm. False when no bucket gets there.
+    bool gather_cells(const std::vector<u64>& v, size_t stride, bool sieve_all,
+                      std::vector<Cell>& cell, CellMap& cm) const {
+        size_t n = (v.size() + stride - 1) / stride;
+        u32 hb = HASH_BITS_MIN;
+        while (hb < HASH_BITS_MAX && (1ULL << hb) < n / 4) ++hb;
+        auto bucket = [hb](u64 x) { return (size_t)(((x >> CELL_BITS) * 0x9E3779B97F4A7C15ULL) >> (64 - hb)); };
+        std::vector<u8> hc(1ULL << hb, 0);
+        u8 hmax = 0;
+        for_sample(v, stride, [&](u64 x) {
+            u8& h = hc[bucket(x)];
+            h += h < 255;
+            hmax = std::max(hmax, h);
+        });
+        auto need = [&](u64 x) {
+            return sieve_all ? 1u : std::max(2u, min_count[bit_length(x)] / (u32)stride);
+        };
+        if (!sieve_all && hmax < need(0)) return false;     // no bucket can pay its offsets
+
+        // Rank members of full buckets by cell, collecting count and span
+        for_sample(v, stride, [&](u64 x) {
+            if (hc[bucket(x)] < need(x)) return;
+            u32 r = cm.rank(x >> CELL_BITS);
+            if (r == cell.size()) cell.push_back({0, x, x});
+            Cell& c = cell[r];
+            ++c.cnt;
+            c.mn = std::min(c.mn, x);
+            c.mx = std::max(c.mx, x);
+        });
+        return true;
+    }
+
+    // Windows start at an odd lo >= 3, so 0, 1 and 2 are left to MR and an
+    // even member always has its odd neighbour below in the window
+    void add_window(Plan& pl, u64 lo, u64 hi, double cost) const {
+        lo = std::max<u64>(lo, 3) | 1;
+        u64 bound = std::min<u64>(isqrt(hi), PRIME_CAP);
+        u64 n_odds = hi >= lo ? ((hi - lo) >> 1) + 1 : 0;
+        pl.win.push_back({lo, hi, (bound + 1) * (bound + 1), pl.words});
+        pl.words += (n_odds + 63) >> 6;
+        pl.est_ms += cost;
+        ++pl.stats.sieved_cells;
+        pl.stats.window_numbers += hi >= lo ? hi - lo + 1 : 0;
+    }
+
+    Plan plan(const std::vector<u64>& v, Strategy strat) const {
+        Plan pl;
+        FilterStats& fs = pl.stats;
+        size_t stride = v.size() >= SAMPLE_STRIDE * 1024 ? SAMPLE_STRIDE : 1;
+        std::vector<Cell> cell;
+        CellMap cm;
+        if (strat == Strategy::SieveOnly) {
+            gather_cells(v, 1, true, cell, cm);
+            pl.cells = std::move(cm);
+            for (const Cell& c : cell) add_window(pl, c.mn, c.mx, window_cost(c.mn, c.mx, c.cnt));
+            stride = 0;                                 // nothing left for MR
+        } else if (strat == Strategy::Adaptive) {
+            if (gather_cells(v, stride, false, cell, cm))
+                for (const Cell& c : cell) {
+                    u64 cb = c.mn >> CELL_BITS << CELL_BITS, pad = stride > 1 ? 2 * (c.mx - c.mn) / c.cnt : 0;
+                    u64 lo = c.mn - std::min(c.mn - cb, pad);
+                    u64 hi = c.mx + std::min<u64>(cb + ((1ULL << CELL_BITS) - 1) - c.mx, pad);
+                    u64 k = c.cnt * stride;
+                    double wc = window_cost(lo, hi, k);
+                    if (wc >= mr_cost(hi, k)) continue;
+                    pl.cells.rank(c.mn >> CELL_BITS);
+                    add_window(pl, lo, hi, wc);
+                }
+            fs.cells = cell.size();
+            fs.sampled_out = pl.win.empty();
+        }
+        pl.win.push_back({UINT64_MAX, 0, 0, 0});       // misses: always outside
+
+        // MR estimate over the sample's values that miss every window
+        double mr_est = 0;
+        if (stride)
+            for_sample(v, stride, [&](u64 x) {
+                const Window& w = pl.win[std::min<size_t>(pl.cells.find(x >> CELL_BITS), pl.win.size() - 1)];
+                if (x < w.lo || x > w.hi) mr_est += mr_ns[bit_length(x)];
+            });
+        pl.est_ms = (pl.est_ms + mr_est * stride) / 1e6;
+        return pl;
+    }
+
+    // Sieve odds of [lo, hi] into bits with primes up to min(sqrt(hi), cap).
+    // Primes below SUB_ODDS walk the window one L1-sized block at a time with
+    // carried offsets, larger ones hit it at most a few times and cross it
+    // directly.
+    void sieve_window(u64 lo, u64 hi, u64* bits, std::vector<u32>& off) const {
+        u64 bound = std::min<u64>(isqrt(hi), PRIME_CAP);
+        size_t np = std::upper_bound(B.begin(), B.end(), (u32)bound) - B.begin();
+        u64 o = lo | 1;
+        u64 n_odds = hi >= o ? ((hi - o) >> 1) + 1 : 0;
+        std::fill(bits, bits + ((n_odds + 63) >> 6), ~0ULL);
+        auto first = [&](u64 p) {
+            u64 start = p * p;
+            if (start < o) {
+                start = ((o + p - 1) / p) * p;
+                if (!(start & 1)) start += p;
+            }
+            return (start - o) >> 1;
+        };
+        size_t ns = 1;
+        for (; ns < np && B[ns] < SUB_ODDS; ++ns) off[ns] = (u32)std::min<u64>(first(B[ns]), n_odds);
+        for (u64 s0 = 0; s0 < n_odds; s0 += SUB_ODDS) {
+            u64 s1 = std::min<u64>(s0 + SUB_ODDS, n_odds);
+            for (size_t i = 1; i < ns; ++i) {
+                u64 k = off[i], p = B[i];
+                for (; k < s1; k += p) bits[k >> 6] &= ~(1ULL << (k & 63));
+                off[i] = (u32)k;
+            }
+        }
+        for (size_t i = ns; i < np; ++i) {
+            u64 p = B[i];
+            if (p * p > hi) break;
+            for (u64 k = first(p); k < n_odds; k += p) bits[k >> 6] &= ~(1ULL << (k & 63));
+        }
+    }
+
+    // Sieve every window, then read the batch back in input order; fs, when
+    // given, gets how many values each path decided
+    std::vector<u8> execute(const std::vector<u64>& v, const Plan& pl, u32 num_threads,
+                            FilterStats* fs = nullptr) const {
+        std::vector<u8> mask(v.size(), 0);
+        std::vector<u64> bits(pl.words);
+        std::atomic<u64> sieved{0};
+        auto parallel = [num_threads](auto&& worker) {
+            std::vector<std::thread> threads;
+            for (u32 i = 0; i < num_threads; ++i)
+                threads.emplace_back(worker);
+            for (auto& t : threads)
+                t.join();
+        };
+        std::atomic<size_t> next{0};
+        parallel([&] {
+            std::vector<u32> off(SUB_ODDS / 2);
+            for (size_t w; (w = next.fetch_add(1)) + 1 < pl.win.size(); )
+                sieve_window(pl.win[w].lo, pl.win[w].hi, bits.data() + pl.win[w].word, off);
+        });
+        next = 0;
+        parallel([&] {
+            const size_t spare = pl.win.size() - 1;
+            u64 local = 0;
+            for (size_t a; (a = next.fetch_add(ITEM_VALUES)) < v.size(); )
+                for (size_t i = a, b = std::min(v.size(), a + ITEM_VALUES); i < b; ++i) {
+                    u64 x = v[i];
+                    const Window& w = pl.win[std::min<size_t>(pl.cells.find(x >> CELL_BITS), spare)];
+                    bool pr;
+                    if (x >= w.lo && x <= w.hi) {
+                        u64 k = (x - 1 + (x & 1) - w.lo) >> 1;
+                        pr = (x & bits[w.word + (k >> 6)] >> (k & 63)) & 1;
+                        if (pr && x >= w.proven) pr = is_prime_mr(x);
+                        ++local;
+                    } else {
+                        pr = is_prime_mr(x);
+                    }
+                    mask[i] = pr;
+                }
+            sieved += local;
+        });
+        if (fs) {
+            fs->sieved_values = sieved;
+            fs->mr_values = v.size() - sieved;
+        }
+        return mask;
+    }
+
+    std::vector<u8> run(const std::vector<u64>& v, Strategy strat, u32 num_threads) const {
+        return execute(v, plan(v, strat), num_threads);
+    }
+};
+
+// ============================================================================
+// Main
+// ============================================================================
+struct Rng {
+    u64 s;
+    u64 next() { s ^= s << 13; s ^= s >> 7; s ^= s << 17; return s; }
+};
+
+int main(int argc, char** argv) {
+    using namespace std::chrono;
+
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4'000'000;
+    u32 num_threads = std::thread::hardware_concurrency();
+    if (num_threads == 0) num_threads = 4;
+
+    std::cout << "=== Density-Adaptive Bulk Primality Filter (" << count << " candidates/batch) ===\n";
+    std::cout << "Threads: " << num_threads << ", cell width 2^" << CELL_BITS
+              << ", base primes to " << PRIME_CAP << "\n\n";
+
+    auto t0 = high_resolution_clock::now();
+    BulkFilter bf;
+    auto t1 = high_resolution_clock::now();
+    std::cout << "Setup:          " << duration_cast<milliseconds>(t1 - t0).count() << " ms\n\n";
+
+    // Batches: dense windows, scattered u64, and a mix of both
+    Rng rng{0x9E3779B97F4A7C15ULL};
+    auto dense = [&](size_t k, u64 centre, u64 width) {
+        std::vector<u64> v(k);
+        for (auto& x : v) x = centre + rng.next() % width;
+        return v;
+    };
+    auto scattered = [&](size_t k) {
+        std::vector<u64> v(k);
+        for (auto& x : v) x = rng.next() >> (rng.next() % 40);      // 24..64-bit magnitudes
+        return v;
+    };
+    std::vector<std::pair<const char*, std::vector<u64>>> batches;
+    batches.push_back({"dense", dense(count, 1'000'000'000'000ULL, count * 8)});
+    batches.push_back({"scattered", scattered(count)});
+    {
+        std::vector<u64> mix;
+        for (int c = 0; c < 8; ++c) {
+            auto d = dense(count / 16, (rng.next() >> 20) + (1ULL << 30), count / 2);
+            mix.insert(mix.end(), d.begin(), d.end());
+        }
+        auto s = scattered(count - mix.size());
+        mix.insert(mix.end(), s.begin(), s.end());
+        for (size_t i = mix.size(); i > 1; --i) std::swap(mix[i - 1], mix[rng.next() % i]);
+        batches.push_back({"mixed", std::move(mix)});
+    }
+
+    bool ok = true;
+    const Strategy strats[3] = {Strategy::Adaptive, Strategy::SieveOnly, Strategy::MROnly};
+    const char* labels[3] = {"Adaptive:   ", "Sieve only: ", "MR only:    "};
+    for (auto& [name, v] : batches) {
+        std::vector<u8> ref;
+        for (int s = 0; s < 3; ++s) {
+            auto a = high_resolution_clock::now();
+            auto pl = bf.plan(v, strats[s]);
+            double plan_ms = duration<double, std::milli>(high_resolution_clock::now() - a).count();
+            if (pl.est_ms > 60'000) {
+                std::cout << "  " << labels[s] << "   skipped (model estimate " << (u64)(pl.est_ms / 1000) << " s)\n";
+                continue;
+            }
+            auto mask = bf.execute(v, pl, num_threads, &pl.stats);
+            double ms = duration<double, std::milli>(high_resolution_clock::now() - a).count();
+            if (s == 0 && pl.stats.sampled_out)
+                std::cout << name << ": no cell worth sieving in the sample, " << pl.stats.mr_values << " by MR\n";
+            else if (s == 0)
+                std::cout << name << ": " << pl.stats.cells << " candidate cells, " << pl.stats.sieved_cells
+                          << " sieved (" << pl.stats.sieved_values << " values over " << pl.stats.window_numbers
+                          << " numbers), " << pl.stats.mr_values << " by MR\n";
+            std::cout << "  " << labels[s] << "   " << ms << " ms (" << v.size() / ms / 1000 << " M/s, plan "
+                      << plan_ms << " ms, model " << pl.est_ms << " ms)\n";
+            if (s == 0) ref = std::move(mask);
+            else if (mask != ref) { ok = false; std::cout << "  masks DIFFER\n"; }
+        }
+        u64 primes = 0;
+        for (u8 m : ref) primes += m;
+        std::cout << "  Found " << primes << " primes\n\n";
+    }
+    std::cout << "────────────────────────\n";
+    std::cout << "Verify: " << (ok ? "OK" : "MISMATCH") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,431 @@
+// c-primes-keygen.cpp
+// Random large prime generation (512-4096 bit) with incremental sieve windows
+// Compile: g++ -O3 -march=native -pthread -std=c++17 c-primes-keygen.cpp -o c-primes-keygen
+// Usage:   c-primes-keygen [seed]
+//
+// NOTE: the RNG below is a deterministic xoshiro256** stand-in so runs are
+// reproducible. Real key generation must draw the start from a CSPRNG.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using u64 = uint64_t;
+using u32 = uint32_t;
+using u128 = unsigned __int128;
+
+inline int ctz64(u64 x) { return __builtin_ctzll(x); }
+
+// ============================================================================
+// Base sieve: the first 100,000 primes end at 1,299,709
+// ============================================================================
+std::vector<u32> base_sieve(u32 n) {
+    u32 h = n / 2 + 1;
+    std::vector<u64> b((h + 63) >> 6, ~0ULL);
+    b[0] ^= 1;
+    for (u32 i = 1, L = (u32)std::sqrt(n) / 2; i <= L; ++i)
+        if (b[i >> 6] >> (i & 63) & 1)
+            for (u32 j = 2*i*(i+1), s = 2*i+1; j < h; j += s)
+                b[j >> 6] &= ~(1ULL << (j & 63));
+    std::vector<u32> P{2};
+    for (u32 i = 0; i < b.size(); ++i)
+        for (auto w = b[i]; w; w &= w - 1) {
+            u32 v = ((i << 6) + ctz64(w)) * 2 + 1;
+            if (v > 1 && v <= n) P.push_back(v);
+        }
+    return P;
+}
+
+// ============================================================================
+// Deterministic RNG stand-in (xoshiro256**, seeded through splitmix64)
+// ============================================================================
+struct Rng {
+    u64 s[4];
+
+    explicit Rng(u64 seed) {
+        for (auto& x : s) {
+            u64 z = (seed += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            x = z ^ (z >> 31);
+        }
+    }
+
+    static u64 rotl(u64 x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    u64 next() {
+        u64 r = rotl(s[1] * 5, 7) * 9, t = s[1] << 17;
+        s[2] ^= s[0]; s[3] ^= s[1]; s[1] ^= s[2]; s[0] ^= s[3];
+        s[2] ^= t; s[3] = rotl(s[3], 45);
+        return r;
+    }
+};
+
+// ============================================================================
+// Bignum: little-endian u64 limbs, fixed length per modulus
+// ============================================================================
+using Big = std::vector<u64>;
+
+// a + b -> out (k limbs), returns carry
+inline u64 add_n(const u64* a, const u64* b, u64* out, size_t k) {
+    u64 c = 0;
+    for (size_t i = 0; i < k; ++i) {
+        u128 s = (u128)a[i] + b[i] + c;
+        out[i] = (u64)s;
+        c = (u64)(s >> 64);
+    }
+    return c;
+}
+
+// a - b -> out (k limbs), returns borrow
+inline u64 sub_n(const u64* a, const u64* b, u64* out, size_t k) {
+    u64 br = 0;
+    for (size_t i = 0; i < k; ++i) {
+        u128 d = (u128)a[i] - b[i] - br;
+        out[i] = (u64)d;
+        br = (u64)(d >> 64) & 1;
+    }
+    return br;
+}
+
+// a * b -> (hi, lo) and a += b -> carry, kept in 64-bit registers: GCC
+// spills u128 accumulators in the CIOS loop
+inline u64 mul_hilo(u64 a, u64 b, u64& lo) {
+    u128 p = (u128)a * b;
+    lo = (u64)p;
+    return (u64)(p >> 64);
+}
+
+inline u64 add_c(u64& a, u64 b) { return __builtin_add_overflow(a, b, &a); }
+
+inline bool geq_n(const u64* a, const u64* b, size_t k) {
+    for (size_t i = k; i-- > 0; )
+        if (a[i] != b[i]) return a[i] > b[i];
+    return true;
+}
+
+inline bool is_zero(const Big& a) {
+    return std::all_of(a.begin(), a.end(), [](u64 x) { return x == 0; });
+}
+
+std::string to_hex(const Big& a) {
+    static const char* D = "0123456789abcdef";
+    std::string s;
+    for (size_t i = a.size(); i-- > 0; )
+        for (int sh = 60; sh >= 0; sh -= 4) s += D[(a[i] >> sh) & 15];
+    size_t nz = s.find_first_not_of('0');
+    return nz == std::string::npos ? "0" : s.substr(nz);
+}
+
+// ============================================================================
+// Montgomery arithmetic mod odd n, R = 2^(64k), CIOS multiplication
+// ============================================================================
+struct MontN {
+    size_t k;
+    Big n, one, r2;        // one = R mod n, r2 = R^2 mod n (only for random bases)
+    u64 n0inv;             // -n^-1 mod 2^64
+    mutable Big t;         // k + 1 limb scratch
+
+    explicit MontN(const Big& n_) : k(n_.size()), n(n_), one(k), t(k + 1) {
+        u64 x = n[0];
+        for (int i = 0; i < 5; ++i) x *= 2 - n[0] * x;  // 3 -> 96 bits
+        n0inv = -x;
+        if (n[k - 1] >> 63) {
+            Big z(k, 0);
+            sub_n(z.data(), n.data(), one.data(), k);   // R - n < n
+        } else {
+            one[0] = 1;                                 // 2^(64k) by doubling
+            for (size_t i = 0; i < 64 * k; ++i) dbl(one);
+        }
+    }
+
+    void dbl(Big& a) const {
+        u64 c = add_n(a.data(), a.data(), a.data(), k);
+        if (c || geq_n(a.data(), n.data(), k)) sub_n(a.data(), n.data(), a.data(), k);
+    }
+
+    void ensure_r2() {
+        if (!r2.empty()) return;
+        r2 = one;
+        for (size_t i = 0; i < 64 * k; ++i) dbl(r2);
+    }
+
+    // out = a * b * R^-1 mod n (out may alias a or b). The a*b[i] and m*n
+    // accumulations run as two independent carry chains in one pass.
+    void mul(const Big& a, const Big& b, Big& out) const {
+        const size_t K = k;
+        const u64 ni = n0inv;
+        const u64* __restrict A = a.data();
+        const u64* __restrict B = b.data();
+        const u64* __restrict N = n.data();
+        u64* __restrict T = t.data();
+        std::fill(T, T + K + 1, 0);
+        for (size_t i = 0; i < K; ++i) {
+            u64 bi = B[i];
+            u128 s = (u128)A[0] * bi + T[0];
+            u64 m = (u64)s * ni, c1 = (u64)(s >> 64);
+            u64 c2 = (u64)(((u128)m * N[0] + (u64)s) >> 64);
+            for (size_t j = 1; j < K; ++j) {
+                u64 lo, hi = mul_hilo(A[j], bi, lo);
+                hi += add_c(lo, T[j]);
+                hi += add_c(lo, c1);
+                c1 = hi;
+                u64 lo2, hi2 = mul_hilo(m, N[j], lo2);
+                hi2 += add_c(lo2, lo);
+                hi2 += add_c(lo2, c2);
+                c2 = hi2;
+                T[j - 1] = lo2;
+            }
+            s = (u128)T[K] + c1 + c2;
+            T[K - 1] = (u64)s;
+            T[K] = (u64)(s >> 64);
+        }
+        if (T[K] || geq_n(T, N, K)) sub_n(T, N, out.data(), K);
+        else std::copy(T, T + K, out.begin());
+    }
+};
+
+// One Miller-Rabin round. base == nullptr means base 2, whose ladder is a
+// squaring plus a doubling per bit; other bases use a fixed 4-bit window.
+bool mr_round(MontN& m, const Big* base) {
+    size_t k = m.k;
+    Big d(m.n), minus_one(k), x(k);
+    d[0] &= ~1ULL;                                     // n - 1 (n odd)
+    sub_n(m.n.data(), m.one.data(), minus_one.data(), k);
+
+    size_t s = 0;
+    while (!d[s / 64]) s += 64;
+    s += ctz64(d[s / 64]);
+    Big e(k, 0);                                       // d = (n - 1) >> s
+    for (size_t i = 0; i < k; ++i) {
+        size_t src = i + s / 64, sh = s % 64;
+        u64 lo = src < k ? d[src] >> sh : 0;
+        u64 hi = (sh && src + 1 < k) ? d[src + 1] << (64 - sh) : 0;
+        e[i] = lo | hi;
+    }
+    size_t top = 64 * k;
+    while (top && !((e[(top - 1) / 64] >> ((top - 1) % 64)) & 1)) --top;
+
+    if (!base) {
+        x = m.one;
+        for (size_t b = top; b-- > 0; ) {
+            m.mul(x, x, x);
+            if ((e[b / 64] >> (b % 64)) & 1) m.dbl(x);
+        }
+    } else {
+        m.ensure_r2();
+        std::vector<Big> tab(16, Big(k));
+        tab[0] = m.one;
+        m.mul(*base, m.r2, tab[1]);
+        for (int i = 2; i < 16; ++i) m.mul(tab[i - 1], tab[1], tab[i]);
+        x = m.one;
+        for (size_t b = (top + 3) & ~size_t(3); b >= 4; b -= 4) {
+            for (int i = 0; i < 4; ++i) m.mul(x, x, x);
+            u32 w = (u32)((e[(b - 4) / 64] >> ((b - 4) % 64)) & 15);
+            if (w) m.mul(x, tab[w], x);
+        }
+    }
+
+    if (x == m.one || x == minus_one) return true;
+    for (size_t r = 1; r < s; ++r) {
+        m.mul(x, x, x);
+        if (x == minus_one) return true;
+        if (x == m.one) return false;
+    }
+    return false;
+}
+
+// Random-base rounds after base 2: keeps the average-case error far below
+// 2^-100 at these sizes (Damgard-Landrock-Pomerance bounds)
+u32 mr_rounds(u32 bits) { return bits < 1024 ? 8 : bits < 2048 ? 5 : bits < 3072 ? 4 : 3; }
+
+bool is_probable_prime(const Big& n, Rng& rng, u32 rounds) {
+    MontN m(n);
+    if (!mr_round(m, nullptr)) return false;
+    for (u32 r = 0; r < rounds; ++r) {
+        Big a(n.size());
+        for (auto& x : a) x = rng.next();
+        a.back() %= n.back() ? n.back() : 1;          // a < n
+        a[0] |= 2;                                     // a >= 2
+        if (!mr_round(m, &a)) return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Incremental sieve windows
+// ============================================================================
+// Candidates start + 2i (i < W) form one window; bit i is cleared when a sieve
+// prime divides the candidate. start mod p is computed once per key, and window
+// w only needs (r0 + 2Ww) mod p, so no further bignum division is done.
+// Windows are claimed by the workers in order; once a prime is found in
+// window w, no window past w is started, and the answer is the first prime in
+// the lowest such window: the smallest prime >= start, independent of timing.
+struct KeyGen {
+    static constexpr u32 W = 1 << 12;                 // 4096 odd candidates
+    std::vector<u32> P;                               // odd sieve primes
+
+    std::vector<double> pd, inv;                      // p and 1/p as doubles
+
+    explicit KeyGen(u32 count) {
+        auto B = base_sieve(1'299'709);
+        P.assign(B.begin() + 1, B.begin() + std::min<size_t>(count + 1, B.size()));
+        for (u32 p : P) { pd.push_back(p); inv.push_back(1.0 / p); }
+    }
+
+    // start mod p for every sieve prime at once, Horner over 16-bit digits.
+    // r * 2^16 + digit < 2^37 is exact in a double, the reciprocal quotient
+    // rounded to nearest (the 1.5 * 2^52 trick, std::floor blocks GCC's
+    // vectorizer) is off by at most one and the FMA remainder is exact, so
+    // the inner loop over primes is branch-free vector code.
+    void residues(const Big& a, std::vector<u32>& r) const {
+        constexpr double RND = 6755399441055744.0;
+        size_t np = P.size();
+        std::vector<double> acc_v(np, 0.0);
+        double* __restrict acc = acc_v.data();
+        const double* __restrict pv = pd.data();
+        const double* __restrict iv = inv.data();
+        for (size_t i = a.size(); i-- > 0; )
+            for (int sh = 48; sh >= 0; sh -= 16) {
+                double d = (double)((a[i] >> sh) & 0xFFFF);
+                for (size_t j = 0; j < np; ++j) {
+                    double x = acc[j] * 65536.0 + d;
+                    double q = (x * iv[j] + RND) - RND;
+                    x = std::fma(-q, pv[j], x);
+                    acc[j] = x < 0 ? x + pv[j] : x;
+                }
+            }
+        for (size_t j = 0; j < np; ++j) r[j] = (u32)acc[j];
+    }
+
+    struct Stats { u64 windows = 0, tested = 0; };
+
+    Big generate(u32 bits, Rng& rng, u32 num_threads, Stats& st) const {
+        size_t k = bits / 64;
+        Big start(k);
+        for (auto& x : start) x = rng.next();
+        start[k - 1] |= 3ULL << 62;                    // Top two bits: full-size products
+        start[0] |= 1;
+
+        std::vector<u32> r0(P.size()), step(P.size());
+        residues(start, r0);
+        for (size_t i = 0; i < P.size(); ++i)
+            step[i] = (u32)((2ULL * W) % P[i]);
+
+        std::atomic<u64> next{0}, found{~0ULL}, windows{0}, tested{0};
+        std::vector<std::pair<u64, Big>> hits(num_threads, {~0ULL, Big()});
+        u32 rounds = mr_rounds(bits);
+
+        auto worker = [&](u32 tid) {
+            std::vector<u64> seg(W / 64);
+            Rng local(rng.s[0] ^ (0x9E3779B97F4A7C15ULL * (tid + 1)));
+            for (u64 w; (w = next.fetch_add(1)) < found.load(); ) {
+                std::fill(seg.begin(), seg.end(), ~0ULL);
+                for (size_t i = 0; i < P.size(); ++i) {
+                    u64 p = P[i];
+                    u64 r = (r0[i] + (u64)step[i] * (w % p)) % p;  // window start mod p
+                    u64 t = r ? p - r : 0;                         // start + t == 0 mod p
+                    if (t & 1) t += p;
+                    for (u64 idx = t >> 1; idx < W; idx += p)
+                        seg[idx >> 6] &= ~(1ULL << (idx & 63));
+                }
+                windows.fetch_add(1);
+
+                Big c(k), off(k, 0);
+                for (u32 i = 0; i < W / 64 && w < found.load(); ++i)
+                    for (auto bitsw = seg[i]; bitsw; bitsw &= bitsw - 1) {
+                        u64 idx = (i << 6) + ctz64(bitsw);
+                        off[0] = 2 * (W * w + idx);            // < 2^64 for any sane w
+                        add_n(start.data(), off.data(), c.data(), k);
+                        tested.fetch_add(1);
+                        if (is_probable_prime(c, local, rounds)) {
+                            u64 cur = found.load();
+                            while (w < cur && !found.compare_exchange_weak(cur, w)) {}
+                            if (w < hits[tid].first) hits[tid] = {w, c};
+                            i = W / 64;
+                            break;
+                        }
+                    }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (u32 i = 0; i < num_threads; ++i)
+            threads.emplace_back(worker, i);
+        for (auto& t : threads)
+            t.join();
+
+        st.windows += windows;
+        st.tested += tested;
+        auto best = std::min_element(hits.begin(), hits.end(),
+                                     [](auto& a, auto& b) { return a.first < b.first; });
+        return best->second;
+    }
+};
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    using namespace std::chrono;
+
+    u64 seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2025;
+    u32 num_threads = std::thread::hardware_concurrency();
+    if (num_threads == 0) num_threads = 4;
+
+    std::cout << "=== Large Prime Generator (seed = " << seed << ", threads = "
+              << num_threads << ") ===\n";
+
+    // Verification: Mersenne primes vs composites of the same shape
+    {
+        Rng rng(seed);
+        auto mersenne = [](u32 e) {
+            Big m((e + 63) / 64, ~0ULL);
+            if (e % 64) m.back() = (1ULL << (e % 64)) - 1;
+            return m;
+        };
+        bool ok = is_probable_prime(mersenne(521), rng, 8)
+               && is_probable_prime(mersenne(1279), rng, 5)
+               && !is_probable_prime(mersenne(523), rng, 8)
+               && !is_probable_prime(mersenne(1277), rng, 5);
+        std::cout << "Verify (M521, M1279 prime; M523, M1277 composite): " << (ok ? "OK\n\n" : "FAIL\n");
+        if (!ok) return 1;
+    }
+
+    auto t0 = high_resolution_clock::now();
+    KeyGen kg(100'000);
+    auto t1 = high_resolution_clock::now();
+    std::cout << "Sieve primes: " << kg.P.size() << " (up to " << kg.P.back() << ", "
+              << duration_cast<milliseconds>(t1 - t0).count() << " ms)\n";
+    std::cout << "Window:       " << KeyGen::W << " odd candidates\n\n";
+
+    struct Run { u32 bits, keys; };
+    Rng rng(seed);
+    for (Run r : {Run{512, 32}, Run{1024, 16}, Run{2048, 4}, Run{3072, 2}, Run{4096, 2}}) {
+        KeyGen::Stats st;
+        std::vector<double> ms;
+        Big last;
+        for (u32 i = 0; i < r.keys; ++i) {
+            auto a = high_resolution_clock::now();
+            last = kg.generate(r.bits, rng, num_threads, st);
+            auto b = high_resolution_clock::now();
+            ms.push_back(duration_cast<microseconds>(b - a).count() / 1000.0);
+        }
+        double sum = 0;
+        for (double x : ms) sum += x;
+        std::sort(ms.begin(), ms.end());
+        std::printf("%4u-bit: %2u keys, mean %9.2f ms, min %9.2f, max %9.2f | %5.1f windows, %6.1f MR-tested per key\n",
+                    r.bits, r.keys, sum / r.keys, ms.front(), ms.back(),
+                    (double)st.windows / r.keys, (double)st.tested / r.keys);
+        if (r.bits == 512) std::cout << "          last: 0x" << to_hex(last) << "\n";
+    }
+    return 0;
+}
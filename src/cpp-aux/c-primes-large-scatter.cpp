@@ -0,0 +1,313 @@
+// c-primes-large-scatter.cpp
+// Large-prime crossing experiment: scalar buckets vs AVX-512 lanes + scatter
+// Compile: g++ -O3 -march=native -std=c++17 c-primes-large-scatter.cpp -o c-primes-large-scatter
+// Usage:   c-primes-large-scatter [width]   (default: 1e8 integers at 1e10, 1e11, 1e12)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#if defined(__AVX512F__) && defined(__AVX512DQ__) && defined(__AVX512CD__) && defined(__AVX512VL__)
+#include <immintrin.h>
+#define HAS_AVX512 1
+#else
+#define HAS_AVX512 0
+#endif
+
+using u64 = uint64_t;
+using u32 = uint32_t;
+
+inline int ctz64(u64 x) { return __builtin_ctzll(x); }
+inline int popcnt64(u64 x) { return __builtin_popcountll(x); }
+
+// ============================================================================
+// Base sieve for primes up to sqrt(n)
+// ============================================================================
+std::vector<u32> base_sieve(u32 n) {
+    u32 h = n / 2 + 1;
+    std::vector<u64> b((h + 63) >> 6, ~0ULL);
+    b[0] ^= 1;
+    for (u32 i = 1, L = (u32)std::sqrt(n) / 2; i <= L; ++i)
+        if (b[i >> 6] >> (i & 63) & 1)
+            for (u32 j = 2*i*(i+1), s = 2*i+1; j < h; j += s)
+                b[j >> 6] &= ~(1ULL << (j & 63));
+    std::vector<u32> P{2};
+    for (u32 i = 0; i < b.size(); ++i)
+        for (auto w = b[i]; w; w &= w - 1) {
+            u32 v = ((i << 6) + ctz64(w)) * 2 + 1;
+            if (v > 1 && v <= n) P.push_back(v);
+        }
+    return P;
+}
+
+// ============================================================================
+// Window layout
+// ============================================================================
+// Bit i of the window is the odd number lo + 2i. Segments are SEG_BITS odds
+// (8 KB), small enough that even the 1e10 window has base primes above it.
+// A prime p >= SEG_BITS hits a segment at most once, since its odd multiples
+// are p bits apart: that is the "large" tier both kernels below handle.
+// Smaller primes cross per segment with carried offsets in every method.
+// Windows start above sqrt(hi), so no base prime lies inside one and every
+// odd multiple >= lo may be crossed without the p^2 clamp.
+constexpr u32 SEG_LOG = 16;
+constexpr u32 SEG_BITS = 1u << SEG_LOG;
+constexpr u32 SEG_WORDS = SEG_BITS / 64;
+constexpr u32 BATCH_SEGS = 16;                  // lane kernel: segments per pass (128 KB)
+constexpr u32 BATCH_BITS = SEG_BITS * BATCH_SEGS;
+
+// Bit index of p's first odd multiple >= lo (lo odd)
+inline u64 first_index(u64 p, u64 lo) {
+    u64 d = (p - lo % p) % p;                   // lo + d is a multiple; odd iff d even
+    return (d + (d & 1 ? p : 0)) >> 1;
+}
+
+struct Window {
+    u64 lo, bits;
+    std::vector<u32> small, large;              // odd base primes below / above SEG_BITS
+
+    Window(u64 lo_, u64 width, const std::vector<u32>& B) : lo(lo_ | 1), bits(width / 2) {
+        u32 r = (u32)std::sqrt((double)(lo + 2 * bits));
+        while ((u64)r * r > lo + 2 * bits) --r;
+        for (size_t i = 1; i < B.size() && B[i] <= r; ++i)
+            (B[i] < SEG_BITS ? small : large).push_back(B[i]);
+    }
+};
+
+// Small primes across one segment; off[] is relative to it and carried on
+void cross_small(u64* seg, u64 len, const std::vector<u32>& P, std::vector<u64>& off) {
+    for (size_t i = 0; i < P.size(); ++i) {
+        u64 k = off[i];
+        for (; k < len; k += P[i]) seg[k >> 6] &= ~(1ULL << (k & 63));
+        off[i] = k - len;
+    }
+}
+
+// Time spent in the large-prime tier, accumulated by every method
+double g_large_ms = 0;
+
+struct LargeTimer {
+    std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+    ~LargeTimer() {
+        g_large_ms += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t0).count();
+    }
+};
+
+inline u64 count_bits(const u64* seg, u64 len) {
+    u64 c = 0, words = (len + 63) >> 6;
+    for (u64 w = 0; w + 1 < words; ++w) c += popcnt64(seg[w]);
+    u64 last = seg[words - 1];
+    if (len & 63) last &= (1ULL << (len & 63)) - 1;
+    return c + popcnt64(last);
+}
+
+// ============================================================================
+// Reference: every prime divides for its start in every segment
+// ============================================================================
+u64 count_plain(const Window& W) {
+    std::vector<u64> seg(SEG_WORDS);
+    u64 cnt = 0;
+    for (u64 s0 = 0; s0 < W.bits; s0 += SEG_BITS) {
+        u64 len = std::min<u64>(SEG_BITS, W.bits - s0), base = W.lo + 2 * s0;
+        std::fill(seg.begin(), seg.end(), ~0ULL);
+        for (u64 p : W.small)
+            for (u64 k = first_index(p, base); k < len; k += p)
+                seg[k >> 6] &= ~(1ULL << (k & 63));
+        {
+            LargeTimer lt;
+            for (u64 p : W.large)
+                for (u64 k = first_index(p, base); k < len; k += p)
+                    seg[k >> 6] &= ~(1ULL << (k & 63));
+        }
+        cnt += count_bits(seg.data(), len);
+    }
+    return cnt;
+}
+
+// ============================================================================
+// Buckets: each large prime is filed under the segment of its next hit
+// ============================================================================
+// A ring of ceil(max p / SEG_BITS) + 1 buckets covers every possible jump.
+// Processing a segment drains its bucket: clear the bit, advance by p, and
+// re-file the prime under the segment it lands in. Primes without a hit in
+// the current segment are never touched.
+u64 count_buckets(const Window& W) {
+    struct Entry { u32 p, off; };
+    size_t ring = W.large.empty() ? 1 : W.large.back() / SEG_BITS + 2;
+    std::vector<std::vector<Entry>> bucket(ring);
+    u64 segs = (W.bits + SEG_BITS - 1) / SEG_BITS;
+    {
+        LargeTimer lt;
+        for (u32 p : W.large) {
+            u64 k = first_index(p, W.lo);
+            if (k < W.bits) bucket[(k >> SEG_LOG) % ring].push_back({p, (u32)(k & (SEG_BITS - 1))});
+        }
+    }
+
+    std::vector<u64> seg(SEG_WORDS), off(W.small.size());
+    for (size_t i = 0; i < W.small.size(); ++i) off[i] = first_index(W.small[i], W.lo);
+    u64 cnt = 0;
+    for (u64 s = 0; s < segs; ++s) {
+        u64 len = std::min<u64>(SEG_BITS, W.bits - s * SEG_BITS);
+        std::fill(seg.begin(), seg.end(), ~0ULL);
+        cross_small(seg.data(), len, W.small, off);
+        {
+            LargeTimer lt;
+            auto& b = bucket[s % ring];
+            for (size_t e = 0; e < b.size(); ++e) {
+                u32 p = b[e].p, k = b[e].off;
+                seg[k >> 6] &= ~(1ULL << (k & 63));
+                u64 next = (u64)k + p;
+                u64 t = s + (next >> SEG_LOG);
+                if (t < segs) bucket[t % ring].push_back({p, (u32)(next & (SEG_BITS - 1))});
+            }
+            b.clear();
+        }
+        cnt += count_bits(seg.data(), len);
+    }
+    return cnt;
+}
+
+// ============================================================================
+// Lanes: large primes 8 at a time over a batch of BATCH_SEGS segments
+// ============================================================================
+// Stateless per batch: each lane finds its prime's first hit from the batch
+// base with a precomputed 1/p (exact quotient, up to one fix-up, while the
+// base stays below 2^52), then strikes the batch bitmap with masked
+// gather/andnot/scatter until every lane runs past the end. VPCONFLICTQ
+// catches two lanes landing on one word; those rare steps go scalar.
+// Batching several segments gives each prime p < BATCH_BITS at least one hit
+// per pass, but primes beyond that still pay the setup every pass.
+#if HAS_AVX512
+void cross_large_avx512(u64* seg, u64 base, u64 len, const u32* P, const double* rcp, size_t count) {
+    const __m512i base_v = _mm512_set1_epi64((long long)base);
+    const __m512d base_d = _mm512_set1_pd((double)base);
+    const __m512i len_v = _mm512_set1_epi64((long long)len);
+    const __m512i one = _mm512_set1_epi64(1), low6 = _mm512_set1_epi64(63);
+    for (size_t g = 0; g < count; g += 8) {
+        __mmask8 lanes = count - g >= 8 ? 0xFF : (__mmask8)((1u << (count - g)) - 1);
+        __m512i p = _mm512_maskz_cvtepu32_epi64(lanes, _mm256_maskz_loadu_epi32(lanes, P + g));
+        __m512d r = _mm512_maskz_loadu_pd(lanes, rcp + g);
+        // base mod p
+        __m512i q = _mm512_cvttpd_epu64(_mm512_mul_pd(base_d, r));
+        __m512i m = _mm512_sub_epi64(base_v, _mm512_mullo_epi64(q, p));
+        m = _mm512_mask_add_epi64(m, _mm512_cmplt_epi64_mask(m, _mm512_setzero_si512()), m, p);
+        m = _mm512_mask_sub_epi64(m, _mm512_cmpge_epi64_mask(m, p), m, p);
+        // d = (p - m) mod p, then the odd multiple's bit index
+        __m512i d = _mm512_sub_epi64(p, m);
+        d = _mm512_mask_sub_epi64(d, _mm512_cmpeq_epi64_mask(d, p), d, p);
+        __mmask8 odd_d = _mm512_test_epi64_mask(d, one);
+        __m512i k = _mm512_srli_epi64(_mm512_mask_add_epi64(d, odd_d, d, p), 1);
+
+        __mmask8 active = _mm512_mask_cmplt_epu64_mask(lanes, k, len_v);
+        while (active) {
+            __m512i word = _mm512_srli_epi64(k, 6);
+            __m512i bit = _mm512_sllv_epi64(one, _mm512_and_si512(k, low6));
+            __m512i conf = _mm512_maskz_conflict_epi64(active, word);
+            if (_mm512_mask_test_epi64_mask(active, conf, _mm512_set1_epi64(active))) {
+                alignas(64) u64 wv[8], bv[8];
+                _mm512_store_si512(wv, word);
+                _mm512_store_si512(bv, bit);
+                for (int l = 0; l < 8; ++l)
+                    if (active >> l & 1) seg[wv[l]] &= ~bv[l];
+            } else {
+                __m512i w = _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), active, word, seg, 8);
+                _mm512_mask_i64scatter_epi64(seg, active, word, _mm512_andnot_si512(bit, w), 8);
+            }
+            k = _mm512_mask_add_epi64(k, active, k, p);
+            active = _mm512_mask_cmplt_epu64_mask(active, k, len_v);
+        }
+    }
+}
+#endif
+
+// Same walk one prime at a time, also the fallback without AVX-512
+void cross_large_scalar(u64* seg, u64 base, u64 len, const u32* P, const double*, size_t count) {
+    for (size_t i = 0; i < count; ++i)
+        for (u64 k = first_index(P[i], base); k < len; k += P[i])
+            seg[k >> 6] &= ~(1ULL << (k & 63));
+}
+
+using LargeKernel = void (*)(u64*, u64, u64, const u32*, const double*, size_t);
+
+u64 count_lanes(const Window& W, LargeKernel cross_large) {
+    std::vector<double> rcp(W.large.size());
+    for (size_t i = 0; i < rcp.size(); ++i) rcp[i] = 1.0 / W.large[i];
+    std::vector<u64> batch(BATCH_BITS / 64), off(W.small.size());
+    for (size_t i = 0; i < W.small.size(); ++i) off[i] = first_index(W.small[i], W.lo);
+    u64 cnt = 0;
+    for (u64 b0 = 0; b0 < W.bits; b0 += BATCH_BITS) {
+        u64 len = std::min<u64>(BATCH_BITS, W.bits - b0);
+        std::fill(batch.begin(), batch.end(), ~0ULL);
+        for (u64 s0 = 0; s0 < len; s0 += SEG_BITS)
+            cross_small(batch.data() + s0 / 64, std::min<u64>(SEG_BITS, len - s0), W.small, off);
+        {
+            LargeTimer lt;
+            cross_large(batch.data(), W.lo + 2 * b0, len, W.large.data(), rcp.data(), W.large.size());
+        }
+        cnt += count_bits(batch.data(), len);
+    }
+    return cnt;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    using namespace std::chrono;
+
+    u64 width = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100'000'000ULL;
+    const u64 starts[] = {10'000'000'000ULL, 100'000'000'000ULL, 1'000'000'000'000ULL};
+
+    std::cout << "=== Large-Prime Crossing: Buckets vs Lanes (width = " << width << ") ===\n";
+    std::cout << "Segment: " << SEG_BITS << " odds (" << SEG_WORDS * 8 / 1024 << " KB), lane batch: "
+              << BATCH_SEGS << " segments\n";
+    std::cout << "Lane kernel: " << (HAS_AVX512 ? "AVX-512 gather/scatter, 8 x u64" : "scalar (no AVX-512)") << "\n\n";
+
+    auto B = base_sieve((u32)std::sqrt((double)(starts[2] + width)) + 1);
+    std::cout << std::fixed << std::setprecision(1);
+
+    bool ok = true;
+    for (u64 lo : starts) {
+        Window W(lo, width, B);
+        std::cout << "[" << lo << ", +" << width << "): " << W.small.size() << " small, "
+                  << W.large.size() << " large base primes\n";
+
+        struct Method { const char* name; u64 (*fn)(const Window&); };
+        const Method methods[] = {
+            {"plain", count_plain},
+            {"buckets", count_buckets},
+            {"lanes scalar", [](const Window& w) { return count_lanes(w, cross_large_scalar); }},
+#if HAS_AVX512
+            {"lanes AVX-512", [](const Window& w) { return count_lanes(w, cross_large_avx512); }},
+#endif
+        };
+        // Best of RUNS, for the whole count and for its large-prime part
+        constexpr int RUNS = 3;
+        u64 ref = 0;
+        for (const auto& m : methods) {
+            u64 c = 0;
+            double ms = 1e30, large_ms = 1e30;
+            for (int r = 0; r < RUNS; ++r) {
+                g_large_ms = 0;
+                auto t0 = high_resolution_clock::now();
+                c = m.fn(W);
+                ms = std::min(ms, duration<double, std::milli>(high_resolution_clock::now() - t0).count());
+                large_ms = std::min(large_ms, g_large_ms);
+            }
+            if (&m == methods) ref = c;
+            ok &= c == ref;
+            std::cout << "  " << m.name << ": " << std::string(14 - std::string(m.name).size(), ' ')
+                      << ms << " ms (large tier " << large_ms << "), " << c << " primes\n";
+        }
+    }
+    std::cout << "────────────────────────\n";
+    std::cout << "Verify: " << (ok ? "OK" : "MISMATCH") << "\n";
+    return ok ? 0 : 1;
+}
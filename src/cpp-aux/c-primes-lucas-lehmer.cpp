@@ -0,0 +1,548 @@
+// c-primes-lucas-lehmer.cpp
+// Mersenne exponent sweep: trial factoring q = 2kp+1 over a k-sieve, then
+// Lucas-Lehmer with irrational-base DWT (IBDWT) FFT squaring and checkpoints
+// Compile: g++ -O3 -march=native -pthread -std=c++17 c-primes-lucas-lehmer.cpp -o c-primes-lucas-lehmer
+// Usage:   c-primes-lucas-lehmer [lo] [hi] [tf_bits] [ckpt_dir]
+//          tests 2^p - 1 for every prime p in [lo, hi] (defaults: 2, 5000, auto, .)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using u64 = uint64_t;
+using u32 = uint32_t;
+using i64 = int64_t;
+using u128 = unsigned __int128;
+
+inline int ctz64(u64 x) { return __builtin_ctzll(x); }
+
+// ============================================================================
+// Base sieve
+// ============================================================================
+std::vector<u32> base_sieve(u32 n) {
+    u32 h = n / 2 + 1;
+    std::vector<u64> b((h + 63) >> 6, ~0ULL);
+    b[0] ^= 1;
+    for (u32 i = 1, L = (u32)std::sqrt(n) / 2; i <= L; ++i)
+        if (b[i >> 6] >> (i & 63) & 1)
+            for (u32 j = 2*i*(i+1), s = 2*i+1; j < h; j += s)
+                b[j >> 6] &= ~(1ULL << (j & 63));
+    std::vector<u32> P{2};
+    for (u32 i = 0; i < b.size(); ++i)
+        for (auto w = b[i]; w; w &= w - 1) {
+            u32 v = ((i << 6) + ctz64(w)) * 2 + 1;
+            if (v > 1 && v <= n) P.push_back(v);
+        }
+    return P;
+}
+
+// ============================================================================
+// Trial factoring: q = 2kp + 1, q = +-1 (mod 8), sieved over k
+// ============================================================================
+// Montgomery-64 for q < 2^63; 2^p mod q by squaring and doubling.
+struct Mont64 {
+    u64 n, ni, one;
+    explicit Mont64(u64 n_) : n(n_) {
+        u64 inv = n;
+        for (int i = 0; i < 5; ++i) inv *= 2 - n * inv;
+        ni = 0 - inv;
+        one = (0 - n) % n;
+    }
+    u64 mul(u64 a, u64 b) const {
+        u128 t = (u128)a * b;
+        u64 m = (u64)t * ni;
+        u64 r = (u64)((t + (u128)m * n) >> 64);
+        return r >= n ? r - n : r;
+    }
+    u64 dbl(u64 a) const { a += a; return a >= n ? a - n : a; }
+};
+
+bool divides_mersenne(u64 p, u64 q) {
+    Mont64 m(q);
+    u64 x = m.one;
+    for (int b = 63 - __builtin_clzll(p); b >= 0; --b) {
+        x = m.mul(x, x);
+        if (p >> b & 1) x = m.dbl(x);
+    }
+    return x == m.one;
+}
+
+u64 inv_mod(u64 a, u64 m) {
+    i64 t = 0, nt = 1, r = (i64)m, nr = (i64)(a % m);
+    while (nr) {
+        i64 q = r / nr;
+        std::swap(t, nt); nt -= q * t;
+        std::swap(r, nr); nr -= q * r;
+    }
+    return (u64)(t < 0 ? t + (i64)m : t);
+}
+
+constexpr u32 TF_WINDOW = 1 << 16;          // k values per sieve window (8KB bitmap)
+constexpr u32 TF_SIEVE_LIMIT = 1 << 15;     // small primes used to sieve k
+
+// Returns the smallest factor q < 2^bits (0 if none). Stops at sqrt(Mp) for
+// small p, in which case `complete` reports that no factor exists at all.
+u64 trial_factor(u64 p, u32 bits, const std::vector<u32>& R, bool& complete) {
+    u64 qmax = bits >= 63 ? (1ULL << 63) - 1 : (1ULL << bits);
+    complete = false;
+    if (p < 126 && (p + 1) / 2 < bits) {
+        qmax = (1ULL << ((p + 1) / 2)) + 1;   // > sqrt(2^p - 1)
+        complete = true;
+    }
+    u64 kmax = (qmax - 1) / (2 * p);
+    if (!kmax) return 0;
+
+    u32 ok4 = 0;                             // k mod 4 classes giving q = +-1 (mod 8)
+    for (u32 c = 0; c < 4; ++c) {
+        u64 q8 = (2 * c * (p % 8) + 1) % 8;
+        if (q8 == 1 || q8 == 7) ok4 |= 1u << c;
+    }
+    std::vector<u32> root(R.size());        // k = root (mod r) gives r | q
+    for (size_t i = 0; i < R.size(); ++i) {
+        u64 r = R[i];
+        root[i] = (u32)((p % r) ? (r - inv_mod(2 * p % r, r)) % r : UINT32_MAX);
+    }
+
+    std::vector<u64> bm(TF_WINDOW / 64);
+    for (u64 k0 = 1; k0 <= kmax; k0 += TF_WINDOW) {
+        u64 len = std::min<u64>(TF_WINDOW, kmax - k0 + 1);
+        std::fill(bm.begin(), bm.end(), 0);
+        for (u64 i = 0; i < len; ++i)
+            if (ok4 >> ((k0 + i) & 3) & 1) bm[i >> 6] |= 1ULL << (i & 63);
+        for (size_t j = 0; j < R.size(); ++j) {
+            if (root[j] == UINT32_MAX) continue;
+            u64 r = R[j], m = k0 % r;
+            u64 idx = root[j] >= m ? root[j] - m : root[j] + r - m;
+            if (2 * (k0 + idx) * p + 1 == r) idx += r;     // q = r itself is a factor, keep it
+            for (; idx < len; idx += r) bm[idx >> 6] &= ~(1ULL << (idx & 63));
+        }
+        for (u64 w = 0; w < (len + 63) / 64; ++w)
+            for (u64 bits_w = bm[w]; bits_w; bits_w &= bits_w - 1) {
+                u64 k = k0 + (w << 6) + ctz64(bits_w);
+                u64 q = 2 * k * p + 1;
+                if (divides_mersenne(p, q)) return q;
+            }
+    }
+    return 0;
+}
+
+// ============================================================================
+// FFT (complex, radix-2, split re/im arrays so the butterflies vectorise)
+// The forward DIF and inverse DIT pair skips both bit-reversal passes; only
+// the real-FFT split step indexes through rev[].
+// ============================================================================
+inline void dif_row(double* __restrict ar, double* __restrict ai, double* __restrict br,
+                    double* __restrict bi, const double* __restrict cr, const double* __restrict ci, u32 h) {
+    for (u32 j = 0; j < h; ++j) {
+        double ur = ar[j], ui = ai[j], vr = br[j], vi = bi[j];
+        ar[j] = ur + vr; ai[j] = ui + vi;
+        double dr = ur - vr, di = ui - vi;
+        br[j] = dr * cr[j] - di * ci[j];
+        bi[j] = dr * ci[j] + di * cr[j];
+    }
+}
+
+inline void dit_row(double* __restrict ar, double* __restrict ai, double* __restrict br,
+                    double* __restrict bi, const double* __restrict cr, const double* __restrict ci, u32 h) {
+    for (u32 j = 0; j < h; ++j) {
+        double tr = br[j] * cr[j] + bi[j] * ci[j];     // conjugate twiddle
+        double ti = bi[j] * cr[j] - br[j] * ci[j];
+        br[j] = ar[j] - tr; bi[j] = ai[j] - ti;
+        ar[j] += tr;        ai[j] += ti;
+    }
+}
+
+struct FFT {
+    u32 m;
+    std::vector<u32> rev;
+    std::vector<double> wr, wi;     // stage with half-length h uses [h - 1, 2h - 1)
+
+    explicit FFT(u32 m_) : m(m_), rev(m_), wr(m_), wi(m_) {
+        u32 lg = ctz64(m);
+        for (u32 i = 0; i < m; ++i) {
+            u32 r = 0;
+            for (u32 b = 0; b < lg; ++b) r |= ((i >> b) & 1) << (lg - 1 - b);
+            rev[i] = r;
+        }
+        for (u32 h = 1; h < m; h <<= 1)
+            for (u32 j = 0; j < h; ++j) {
+                long double a = -3.14159265358979323846264338327950288L * j / h;
+                wr[h - 1 + j] = (double)std::cos(a);
+                wi[h - 1 + j] = (double)std::sin(a);
+            }
+    }
+
+    // Stages with h < 8 are too short to vectorise along j; walk the blocks
+    // per twiddle instead so the loop overhead is paid once per j
+    template <bool INV>
+    void short_stage(double* __restrict re, double* __restrict im, u32 h) const {
+        for (u32 j = 0; j < h; ++j) {
+            double c = wr[h - 1 + j], s = wi[h - 1 + j];
+            for (u32 b = j; b < m; b += 2 * h) {
+                double ur = re[b], ui = im[b], vr = re[b + h], vi = im[b + h];
+                if (!INV) {
+                    re[b] = ur + vr; im[b] = ui + vi;
+                    double dr = ur - vr, di = ui - vi;
+                    re[b + h] = dr * c - di * s;
+                    im[b + h] = dr * s + di * c;
+                } else {
+                    double tr = vr * c + vi * s, ti = vi * c - vr * s;
+                    re[b + h] = ur - tr; im[b + h] = ui - ti;
+                    re[b] = ur + tr;     im[b] = ui + ti;
+                }
+            }
+        }
+    }
+
+    // Forward DIF: natural order in, bit-reversed order out
+    void forward(double* re, double* im) const {
+        for (u32 h = m >> 1; h >= 1; h >>= 1) {
+            if (h < 8) { short_stage<false>(re, im, h); continue; }
+            const double* cr = &wr[h - 1];
+            const double* ci = &wi[h - 1];
+            for (u32 b = 0; b < m; b += 2 * h) {
+                dif_row(re + b, im + b, re + b + h, im + b + h, cr, ci, h);
+            }
+        }
+    }
+
+    // Inverse DIT: bit-reversed order in, natural order out, no 1/m scaling
+    void inverse(double* re, double* im) const {
+        for (u32 h = 1; h < m; h <<= 1) {
+            if (h < 8) { short_stage<true>(re, im, h); continue; }
+            const double* cr = &wr[h - 1];
+            const double* ci = &wi[h - 1];
+            for (u32 b = 0; b < m; b += 2 * h) {
+                dit_row(re + b, im + b, re + b + h, im + b + h, cr, ci, h);
+            }
+        }
+    }
+};
+
+// ============================================================================
+// Lucas-Lehmer with IBDWT squaring mod 2^p - 1
+// ============================================================================
+// x = sum x_j 2^ceil(pj/n) with n words of floor(p/n) or ceil(p/n) bits kept
+// in balanced form. Weighting x_j by a_j = 2^(ceil(pj/n) - pj/n) turns the
+// mod 2^p - 1 product into a plain cyclic convolution (Crandall-Fagin), so
+// one length-n real FFT squares with no zero padding. The real FFT is a
+// length-n/2 complex FFT of (x_2j + i x_2j+1) plus a split step.
+constexpr double MAX_BITS_PER_WORD = 18.5;
+constexpr double MAX_ROUNDOFF = 0.4;
+constexpr double CKPT_SECONDS = 60;
+
+struct LLState {
+    u64 p;
+    u32 n;
+    std::vector<u32> bits;
+    std::vector<double> a, ia;      // weights and 1 / (m * a_j)
+    std::vector<double> sr, si, tr, ti, wkr, wki;
+    FFT fft;
+    std::vector<i64> x, hi, sh, half;   // digits, carry scratch, per-word shift and 2^(b-1)
+    double max_err = 0;
+
+    static u32 choose_n(u64 p) {
+        u32 n = 32;
+        while ((double)p / n > MAX_BITS_PER_WORD) n <<= 1;
+        return n;
+    }
+
+    explicit LLState(u64 p_) : p(p_), n(choose_n(p_)), fft(n / 2) {
+        u32 m = n / 2;
+        bits.resize(n); a.resize(n); ia.resize(n); x.assign(n, 0);
+        hi.resize(n); sh.resize(n); half.resize(n);
+        sr.resize(m); si.resize(m); tr.resize(m); ti.resize(m); wkr.resize(m); wki.resize(m);
+        for (u32 j = 0; j < n; ++j) {
+            u64 c0 = (p * j + n - 1) / n, c1 = (p * (j + 1) + n - 1) / n;
+            bits[j] = (u32)(c1 - c0);
+            sh[j] = bits[j];
+            half[j] = 1LL << (bits[j] - 1);
+            long double e = (long double)c0 - (long double)p * j / n;
+            a[j] = (double)std::exp2(e);
+            ia[j] = (double)(1.0L / (std::exp2(e) * m));
+        }
+        for (u32 k = 0; k < m; ++k) {           // w^k, w = e^{-2 pi i / n}
+            long double ang = -2 * 3.14159265358979323846264338327950288L * k / n;
+            wkr[k] = (double)std::cos(ang);
+            wki[k] = (double)std::sin(ang);
+        }
+        x[0] = 4;
+        carry();
+    }
+
+    // Propagate carries with wrap-around (2^p = 1). Each pass splits every
+    // word independently (no serial carry chain, so it vectorises) and adds
+    // the high part into the next word. Once no carry exceeds +-1 the digits
+    // are balanced to within one unit, which is all the roundoff bound needs.
+    void carry() {
+        i64* __restrict xv = x.data();
+        i64* __restrict hv = hi.data();
+        const i64* __restrict sv = sh.data();
+        const i64* __restrict hf = half.data();
+        for (int pass = 0; pass < 16; ++pass) {
+            i64 mx = 0;
+            for (u32 j = 0; j < n; ++j) {
+                i64 h = (xv[j] + hf[j]) >> sv[j];
+                hv[j] = h;
+                xv[j] -= h << sv[j];
+                mx = std::max(mx, h < 0 ? -h : h);
+            }
+            xv[0] += hv[n - 1];
+            for (u32 j = 1; j < n; ++j) xv[j] += hv[j - 1];
+            if (mx <= 1) break;
+        }
+    }
+
+    // x = x^2 - 2 (mod 2^p - 1)
+    void step() {
+        const u32 m = n / 2;
+        for (u32 j = 0; j < m; ++j) {
+            sr[j] = x[2 * j] * a[2 * j];
+            si[j] = x[2 * j + 1] * a[2 * j + 1];
+        }
+        fft.forward(sr.data(), si.data());
+        // split into the length-n real spectrum, square, and pack back;
+        // the spectrum is in bit-reversed order, so index through rev[]
+        const u32* rev = fft.rev.data();
+        for (u32 k = 0; k < m; ++k) {
+            u32 K = rev[k], K2 = rev[(m - k) & (m - 1)];
+            double zr = sr[K], zi = si[K], cr = sr[K2], ci = -si[K2];      // Z_k, conj(Z_{m-k})
+            double er = 0.5 * (zr + cr), ei = 0.5 * (zi + ci);             // E_k
+            double dr = 0.5 * (zr - cr), di = 0.5 * (zi - ci);             // O_k = (Z - conj) / 2i
+            double orr = di, oi = -dr;
+            double wr = wkr[k], wi = wki[k];
+            double tr_ = orr * wr - oi * wi, ti_ = orr * wi + oi * wr;     // w^k O_k
+            double xr = er + tr_, xi = ei + ti_;                            // X_k
+            double yr = er - tr_, yi = ei - ti_;                            // X_{k+m}
+            double Ar = xr * xr - xi * xi, Ai = 2 * xr * xi;                // squares
+            double Br = yr * yr - yi * yi, Bi = 2 * yr * yi;
+            double e2r = 0.5 * (Ar + Br), e2i = 0.5 * (Ai + Bi);
+            double fr = 0.5 * (Ar - Br), fi = 0.5 * (Ai - Bi);
+            double o2r = fr * wr + fi * wi, o2i = fi * wr - fr * wi;        // / w^k
+            tr[K] = e2r - o2i;                                              // E + i O
+            ti[K] = e2i + o2r;
+        }
+        fft.inverse(tr.data(), ti.data());
+        const double RND = 6755399441055744.0;      // 1.5 * 2^52: add/sub rounds to nearest
+        double err = 0;
+        for (u32 j = 0; j < m; ++j) {
+            double v0 = tr[j] * ia[2 * j], v1 = ti[j] * ia[2 * j + 1];
+            double r0 = (v0 + RND) - RND, r1 = (v1 + RND) - RND;
+            err = std::max(err, std::max(std::fabs(v0 - r0), std::fabs(v1 - r1)));
+            x[2 * j] = (i64)r0;
+            x[2 * j + 1] = (i64)r1;
+        }
+        max_err = std::max(max_err, err);
+        x[0] -= 2;
+        carry();
+    }
+
+    // Canonical residue: digits in [0, 2^b), Mp itself read as 0
+    std::vector<u64> residue() const {
+        std::vector<i64> y = x;
+        for (int pass = 0; pass < 4; ++pass) {
+            i64 c = 0;
+            for (u32 j = 0; j < n; ++j) {
+                i64 v = y[j] + c;
+                i64 d = v & ((1LL << bits[j]) - 1);
+                c = (v - d) >> bits[j];
+                y[j] = d;
+            }
+            y[0] += c;
+            if (!c) break;
+        }
+        std::vector<u64> r((p + 63) / 64, 0);
+        bool all_ones = true;
+        u64 pos = 0;
+        for (u32 j = 0; j < n; ++j) {
+            if (y[j] != (1LL << bits[j]) - 1) all_ones = false;
+            for (u32 b = 0; b < bits[j]; ++b, ++pos)
+                if (y[j] >> b & 1) r[pos / 64] |= 1ULL << (pos % 64);
+        }
+        if (all_ones) std::fill(r.begin(), r.end(), 0);
+        return r;
+    }
+
+    // Checkpoint: p, n, iteration, then the n balanced digits
+    bool save(const std::string& path, u64 iter) const {
+        std::string tmp = path + ".tmp";
+        FILE* f = std::fopen(tmp.c_str(), "wb");
+        if (!f) return false;
+        const char magic[4] = {'L', 'L', 'C', '1'};
+        bool ok = std::fwrite(magic, 1, 4, f) == 4 && std::fwrite(&p, 8, 1, f) == 1 &&
+                  std::fwrite(&n, 4, 1, f) == 1 && std::fwrite(&iter, 8, 1, f) == 1 &&
+                  std::fwrite(x.data(), 8, n, f) == n;
+        ok &= std::fclose(f) == 0;
+        return ok && std::rename(tmp.c_str(), path.c_str()) == 0;
+    }
+
+    bool load(const std::string& path, u64& iter) {
+        FILE* f = std::fopen(path.c_str(), "rb");
+        if (!f) return false;
+        char magic[4];
+        u64 fp;
+        u32 fn;
+        std::vector<i64> y(n);
+        bool ok = std::fread(magic, 1, 4, f) == 4 && std::string(magic, 4) == "LLC1" &&
+                  std::fread(&fp, 8, 1, f) == 1 && fp == p && std::fread(&fn, 4, 1, f) == 1 && fn == n &&
+                  std::fread(&iter, 8, 1, f) == 1 && std::fread(y.data(), 8, n, f) == n;
+        std::fclose(f);
+        if (ok) x = std::move(y);
+        return ok;
+    }
+};
+
+// p < 64: plain 128-bit arithmetic, 2^p - 1 < 2^63
+bool ll_small(u64 p) {
+    if (p == 2) return true;
+    u64 M = (1ULL << p) - 1, s = 4;
+    for (u64 i = 0; i < p - 2; ++i) {
+        u128 t = (u128)s * s;
+        u64 r = (u64)(t & M) + (u64)(t >> p);
+        r = (r & M) + (r >> p);
+        if (r >= M) r -= M;
+        s = r >= 2 ? r - 2 : r + M - 2;
+    }
+    return s == 0;
+}
+
+struct Result {
+    u64 p = 0;
+    u64 factor = 0;         // trial factoring hit
+    bool tf_complete = false, prime = false;
+    u64 res64 = 0;
+    u32 n = 0;
+    double max_err = 0, seconds = 0;
+    u64 resumed_at = 0;
+};
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    using namespace std::chrono;
+
+    u64 lo = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2;
+    u64 hi = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5000;
+    int tf_arg = argc > 3 ? std::atoi(argv[3]) : 0;
+    std::string ckpt_dir = argc > 4 ? argv[4] : ".";
+    if (hi > 100'000'000 || lo > hi) { std::cerr << "need lo <= hi <= 1e8\n"; return 1; }
+
+    u32 num_threads = std::thread::hardware_concurrency();
+    if (num_threads == 0) num_threads = 4;
+
+    auto P = base_sieve((u32)hi);
+    std::vector<u64> exps;
+    for (u32 p : P) if (p >= lo) exps.push_back(p);
+    std::vector<u32> R = base_sieve(TF_SIEVE_LIMIT);
+    R.erase(R.begin());                      // r = 2 never divides q
+
+    std::cout << "=== Lucas-Lehmer Mersenne Sweep: prime p in [" << lo << ", " << hi << "] ===\n";
+    std::cout << "Exponents: " << exps.size() << ", threads: " << num_threads
+              << ", checkpoints every " << CKPT_SECONDS << " s in " << ckpt_dir << "\n\n";
+
+    auto t0 = high_resolution_clock::now();
+    std::vector<Result> results(exps.size());
+    std::atomic<size_t> next{0};
+    std::mutex out_mtx;
+
+    auto worker = [&]() {
+        for (size_t i; (i = next.fetch_add(1)) < exps.size(); ) {
+            auto ts = high_resolution_clock::now();
+            u64 p = exps[i];
+            Result& r = results[i];
+            r.p = p;
+            u32 bits = tf_arg > 0 ? (u32)tf_arg
+                                  : (u32)std::min(62.0, std::max(24.0, 3 * std::log2((double)p) - 5));
+            r.factor = trial_factor(p, std::min(bits, 62u), R, r.tf_complete);
+            if (r.factor || r.tf_complete) {
+                r.prime = !r.factor;
+            } else if (p < 64) {
+                r.prime = ll_small(p);
+            } else {
+                LLState st(p);
+                r.n = st.n;
+                std::string path = ckpt_dir + "/ll_" + std::to_string(p) + ".ckpt";
+                u64 it = 0;
+                if (st.load(path, it)) r.resumed_at = it;
+                auto last = high_resolution_clock::now();
+                for (; it < p - 2; ++it) {
+                    st.step();
+                    if (st.max_err > MAX_ROUNDOFF) break;
+                    if ((it & 1023) == 0 && duration<double>(high_resolution_clock::now() - last).count() > CKPT_SECONDS) {
+                        st.save(path, it + 1);
+                        last = high_resolution_clock::now();
+                        std::lock_guard<std::mutex> lk(out_mtx);
+                        std::cout << "  M" << p << ": " << it + 1 << " / " << p - 2 << " ("
+                                  << 100.0 * (it + 1) / (p - 2) << "%), checkpointed" << std::endl;
+                    }
+                }
+                r.max_err = st.max_err;
+                auto res = st.residue();
+                r.res64 = res[0];
+                r.prime = st.max_err <= MAX_ROUNDOFF &&
+                          std::all_of(res.begin(), res.end(), [](u64 w) { return w == 0; });
+                std::remove(path.c_str());
+            }
+            r.seconds = duration<double>(high_resolution_clock::now() - ts).count();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (u32 i = 0; i < num_threads; ++i)
+        threads.emplace_back(worker);
+    for (auto& t : threads)
+        t.join();
+    auto t1 = high_resolution_clock::now();
+
+    u64 n_tf = 0, n_ll = 0, n_tf_proof = 0;
+    double ll_s = 0, tf_only_s = 0;
+    std::vector<u64> primes;
+    bool err_abort = false;
+    for (auto& r : results) {
+        if (r.factor) { ++n_tf; tf_only_s += r.seconds; }
+        else if (r.tf_complete) ++n_tf_proof;
+        else { ++n_ll; ll_s += r.seconds; }
+        if (r.prime) primes.push_back(r.p);
+        if (r.max_err > MAX_ROUNDOFF) err_abort = true;
+    }
+
+    std::cout << "Trial factoring eliminated: " << n_tf << " of " << exps.size() << " ("
+              << 100.0 * n_tf / std::max<size_t>(exps.size(), 1) << "%)\n";
+    std::cout << "Decided by trial division to sqrt(Mp): " << n_tf_proof << "\n";
+    std::cout << "Lucas-Lehmer tests: " << n_ll << " (" << ll_s << " s thread time)\n";
+    std::cout << "────────────────────────\n";
+    std::cout << "Total: " << duration<double>(t1 - t0).count() << " s\n\n";
+
+    std::cout << "Mersenne primes found: " << primes.size() << "\n  ";
+    for (u64 p : primes) std::cout << "M" << p << ' ';
+    std::cout << "\n\n";
+
+    // Largest few exponents in detail
+    std::cout << "Largest exponents:\n";
+    for (size_t i = results.size() > 5 ? results.size() - 5 : 0; i < results.size(); ++i) {
+        auto& r = results[i];
+        std::cout << "  M" << r.p << ": ";
+        if (r.factor) std::cout << "factor " << r.factor;
+        else if (r.tf_complete) std::cout << (r.prime ? "prime" : "composite") << " (trial division)";
+        else {
+            char buf[32];
+            std::snprintf(buf, sizeof buf, "%016llx", (unsigned long long)r.res64);
+            std::cout << (r.prime ? "PRIME" : "composite") << ", res64 " << buf << ", FFT " << r.n
+                      << ", max roundoff " << r.max_err;
+            if (r.resumed_at) std::cout << ", resumed at " << r.resumed_at;
+        }
+        std::cout << " (" << r.seconds << " s)\n";
+    }
+    if (err_abort) std::cout << "\nWARNING: roundoff above " << MAX_ROUNDOFF << ", results unreliable\n";
+    return err_abort ? 1 : 0;
+}
@@ -0,0 +1,381 @@
+// c-primes-mertens.cpp
+// Mertens function M(x) = sum mu(n) in O(x^(2/3)) (Deleglise-Rivat splitting)
+// with a segmented Moebius sieve and threaded phases, exact in 64 bits
+// Compile: g++ -O3 -march=native -pthread -std=c++17 c-primes-mertens.cpp -o c-primes-mertens
+// Usage:   c-primes-mertens [x] [verify_limit]   (defaults: 1e12, 1e9; 0 skips verification)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using u64 = uint64_t;
+using u32 = uint32_t;
+using i64 = int64_t;
+using i32 = int32_t;
+using i8 = int8_t;
+
+inline int ctz64(u64 x) { return __builtin_ctzll(x); }
+
+// ============================================================================
+// Base sieve
+// ============================================================================
+std::vector<u32> base_sieve(u32 n) {
+    u32 h = n / 2 + 1;
+    std::vector<u64> b((h + 63) >> 6, ~0ULL);
+    b[0] ^= 1;
+    for (u32 i = 1, L = (u32)std::sqrt(n) / 2; i <= L; ++i)
+        if (b[i >> 6] >> (i & 63) & 1)
+            for (u32 j = 2*i*(i+1), s = 2*i+1; j < h; j += s)
+                b[j >> 6] &= ~(1ULL << (j & 63));
+    std::vector<u32> P{2};
+    for (u32 i = 0; i < b.size(); ++i)
+        for (auto w = b[i]; w; w &= w - 1) {
+            u32 v = ((i << 6) + ctz64(w)) * 2 + 1;
+            if (v > 1 && v <= n) P.push_back(v);
+        }
+    return P;
+}
+
+u64 isqrt(u64 n) {
+    u64 r = (u64)std::sqrt((double)n);
+    while (r * r > n) --r;
+    while ((r + 1) * (r + 1) <= n) ++r;
+    return r;
+}
+
+u64 icbrt(u64 n) {
+    u64 r = (u64)std::cbrt((double)n);
+    while (r * r * r > n) --r;
+    while ((r + 1) * (r + 1) * (r + 1) <= n) ++r;
+    return r;
+}
+
+// ============================================================================
+// Segmented Moebius sieve
+// ============================================================================
+// One signed product per value: every prime p < sqrt(end) multiplies it by
+// -p and every p^2 zeroes it, so the sign is (-1)^(small prime divisors)
+// and 0 marks squareful n. A squarefree n whose |product| falls short of n
+// has exactly one prime factor above sqrt(end), so mu takes the other sign.
+// |product| divides n, so it never overflows. Primes 2, 3, 5, 7 and their
+// squares come from a precomputed pattern of period (2*3*5*7)^2 = 44100.
+constexpr u32 S = 1 << 17;              // values per segment (~1.2MB working set)
+constexpr u32 SEGS_PER_BLOCK = 32;      // segments sharing one offset setup
+constexpr u32 PAT = 44100;
+constexpr size_t PAT_PRIMES = 4;
+
+const std::vector<i64>& wheel_pattern() {
+    static const std::vector<i64> pat = [] {
+        std::vector<i64> v(PAT);
+        for (u32 r = 0; r < PAT; ++r) {
+            i64 x = 1;
+            for (i64 p : {2, 3, 5, 7}) {
+                if (r % (p * p) == 0) { x = 0; break; }
+                if (r % p == 0) x *= -p;
+            }
+            v[r] = x;
+        }
+        return v;
+    }();
+    return pat;
+}
+
+struct MoebiusSegments {
+    const std::vector<u32>& P;
+    const std::vector<i64>& pat;
+    std::vector<u64> off, off2;         // next multiple of p / p^2, relative to cur
+    u64 cur = 0;
+    size_t np = 0;                      // primes set up by start()
+    std::vector<i64> prod;
+
+    explicit MoebiusSegments(const std::vector<u32>& P_)
+        : P(P_), pat(wheel_pattern()), off(P_.size()), off2(P_.size()), prod(S) {}
+
+    // Position at lo; primes with p^2 >= end are not needed before end
+    void start(u64 lo, u64 end) {
+        cur = lo;
+        for (np = PAT_PRIMES; np < P.size(); ++np) {
+            u64 p = P[np], pp = p * p;
+            if (pp >= end) break;
+            off[np] = (p - lo % p) % p;
+            off2[np] = (pp - lo % pp) % pp;
+        }
+    }
+
+    // mu[i] = mu(cur + i) for i < len, then advance cur by len
+    void next(i8* __restrict mu, u32 len) {
+        i64* __restrict pr = prod.data();
+        for (u32 i = 0, r = (u32)(cur % PAT); i < len; ) {
+            u32 c = std::min(len - i, PAT - r);
+            std::copy(pat.begin() + r, pat.begin() + r + c, pr + i);
+            i += c;
+            r = 0;
+        }
+        for (size_t i = PAT_PRIMES; i < np; ++i) {
+            i64 p = P[i];
+            u64 j = off[i];
+            for (; j < len; j += p) pr[j] *= -p;
+            off[i] = j - len;
+            u64 pp = (u64)p * p, k = off2[i];
+            for (; k < len; k += pp) pr[k] = 0;
+            off2[i] = k - len;
+        }
+        for (u32 i = 0; i < len; ++i) {
+            i64 v = pr[i];
+            i8 sg = (i8)((v > 0) - (v < 0));
+            mu[i] = (u64)(v < 0 ? -v : v) == cur + i ? sg : (i8)-sg;
+        }
+        cur += len;
+    }
+};
+
+// ============================================================================
+// Mertens
+// ============================================================================
+// M(x) = M(u) - sum_{m<=u} mu(m) sum_{u/m < n <= x/m} M(x/(mn)),  1 <= u <= x.
+// Quotients x/(mn) up to Q0 = max(sqrt x, u) come from a table (phase B,
+// threaded over m); the rest lie in (Q0, x/(u+1)] and are met in increasing
+// order while a segmented sieve walks that range (phase A, threaded over
+// blocks). A block can't know M at its own start, so it returns the pair
+// count W and the sum of local prefixes L; the ordered merge adds M_start*W.
+constexpr double U_FACTOR = 1.5;        // u = U_FACTOR * x^(1/3), tuned at 1e13-1e14
+
+struct MertensResult {
+    i64 value;
+    u64 u, q0, hi_a;
+    double table_s, phase_b_s, phase_a_s;
+};
+
+MertensResult mertens(u64 x, u32 num_threads) {
+    using namespace std::chrono;
+    auto t0 = high_resolution_clock::now();
+
+    u64 u = std::max<u64>(1, (u64)(U_FACTOR * icbrt(x)));
+    u64 q0 = std::max(isqrt(x), u);
+    u64 hi_a = x / (u + 1);             // largest quotient phase A can meet
+
+    auto P = base_sieve((u32)isqrt(std::max(q0, hi_a)) + 1);
+
+    // Table: mu and M up to q0
+    std::vector<i8> mu_t(q0 + 1);
+    std::vector<i32> M(q0 + 1);
+    {
+        MoebiusSegments ms(P);
+        ms.start(1, q0 + 1);
+        for (u64 lo = 1; lo <= q0; lo += S) {
+            u32 len = (u32)std::min<u64>(S, q0 + 1 - lo);
+            ms.next(&mu_t[lo], len);
+        }
+        for (u64 i = 1; i <= q0; ++i) M[i] = M[i - 1] + mu_t[i];
+    }
+    auto t1 = high_resolution_clock::now();
+
+    // Phase B: quotients <= q0
+    constexpr u64 M_BLOCK = 256;
+    std::atomic<u64> next_m{1};
+    std::vector<i64> sum_b(num_threads, 0);
+    auto worker_b = [&](u32 tid) {
+        i64 acc = 0;
+        for (u64 m0; (m0 = next_m.fetch_add(M_BLOCK)) <= u; ) {
+            for (u64 m = m0, me = std::min(u, m0 + M_BLOCK - 1); m <= me; ++m) {
+                if (!mu_t[m]) continue;
+                u64 z = x / m;
+                u64 n0 = std::max(u / m, z / (q0 + 1));     // n > n0
+                u64 s = isqrt(z);
+                u64 N0 = std::max(n0, s);
+                u64 qmax = z / (N0 + 1);
+                // n <= sqrt z one at a time; n > N0 grouped by q = z/n, which
+                // by Abel summation is sum mu(q) floor(z/q) - M(qmax) N0
+                i64 sum = -(i64)M[qmax] * (i64)N0;
+                if (z < (1ULL << 52)) {         // double quotient floors exactly
+                    const double zd = (double)z;
+                    for (u64 n = n0 + 1; n <= s; ++n) sum += M[(u64)(zd / (double)n)];
+                    for (u64 q = 1; q <= qmax; ++q) sum += mu_t[q] * (i64)(zd / (double)q);
+                } else {
+                    for (u64 n = n0 + 1; n <= s; ++n) sum += M[z / n];
+                    for (u64 q = 1; q <= qmax; ++q) sum += mu_t[q] * (i64)(z / q);
+                }
+                acc += mu_t[m] * sum;
+            }
+        }
+        sum_b[tid] = acc;
+    };
+    {
+        std::vector<std::thread> threads;
+        for (u32 i = 0; i < num_threads; ++i) threads.emplace_back(worker_b, i);
+        for (auto& t : threads) t.join();
+    }
+    auto t2 = high_resolution_clock::now();
+
+    // Phase A: quotients in (q0, hi_a], segmented
+    struct BlockOut { i64 musum = 0, W = 0, L = 0; };
+    const u64 a_lo = q0 + 1;
+    const u64 block_len = (u64)S * SEGS_PER_BLOCK;
+    const u64 n_blocks = hi_a >= a_lo ? (hi_a - a_lo) / block_len + 1 : 0;
+    std::vector<BlockOut> blocks(n_blocks);
+    std::vector<u64> ms_list;                   // squarefree m <= u
+    for (u64 m = 1; m <= u; ++m) if (mu_t[m]) ms_list.push_back(m);
+
+    std::atomic<u64> next_block{0};
+    auto worker_a = [&]() {
+        MoebiusSegments ms(P);
+        std::vector<i8> mu(S);
+        std::vector<i32> pref(S);
+        struct Active { u64 z, n, stop, q; i64 mu; };
+        std::vector<Active> act;
+        for (u64 b; (b = next_block.fetch_add(1)) < n_blocks; ) {
+            u64 A = a_lo + b * block_len, B = std::min(A + block_len, hi_a + 1);
+            act.clear();
+            for (u64 m : ms_list) {
+                u64 z = x / m;
+                u64 n_hi = z / A;
+                u64 n_lo = std::max(z / B, u / m);          // n in (n_lo, n_hi]
+                if (n_hi > n_lo) act.push_back({z, n_hi, n_lo, z / n_hi, mu_t[m]});
+            }
+            BlockOut out;
+            ms.start(A, B);
+            for (u64 sl = A; sl < B; sl += S) {
+                u32 len = (u32)std::min<u64>(S, B - sl);
+                u64 sh = sl + len;
+                ms.next(mu.data(), len);
+                i32 run = 0;
+                for (u32 i = 0; i < len; ++i) { run += mu[i]; pref[i] = run; }
+                i64 base = out.musum;                   // sum of mu over [A, sl)
+                for (size_t i = 0; i < act.size(); ) {
+                    Active& a = act[i];
+                    while (a.q < sh) {
+                        out.W += a.mu;
+                        out.L += a.mu * (base + pref[a.q - sl]);
+                        if (--a.n == a.stop) { a.q = UINT64_MAX; break; }
+                        a.q = a.z / a.n;
+                    }
+                    if (a.q == UINT64_MAX) { a = act.back(); act.pop_back(); }
+                    else ++i;
+                }
+                out.musum += run;
+            }
+            blocks[b] = out;
+        }
+    };
+    {
+        std::vector<std::thread> threads;
+        for (u32 i = 0; i < num_threads; ++i) threads.emplace_back(worker_a);
+        for (auto& t : threads) t.join();
+    }
+
+    i64 total = 0, m_start = M[q0];
+    for (auto& o : blocks) {
+        total += m_start * o.W + o.L;
+        m_start += o.musum;
+    }
+    for (i64 v : sum_b) total += v;
+    auto t3 = high_resolution_clock::now();
+
+    MertensResult r;
+    r.value = M[u] - total;
+    r.u = u; r.q0 = q0; r.hi_a = hi_a;
+    r.table_s = duration<double>(t1 - t0).count();
+    r.phase_b_s = duration<double>(t2 - t1).count();
+    r.phase_a_s = duration<double>(t3 - t2).count();
+    return r;
+}
+
+// Direct summation to `limit`, reporting M at each checkpoint (sorted)
+std::vector<i64> mertens_direct(u64 limit, const std::vector<u64>& cps, u32 num_threads) {
+    auto P = base_sieve((u32)isqrt(limit) + 1);
+    const u64 block_len = (u64)S * SEGS_PER_BLOCK;
+    const u64 n_blocks = (limit - 1) / block_len + 1;
+    std::vector<std::vector<i64>> part(num_threads, std::vector<i64>(cps.size(), 0));
+    std::atomic<u64> next_block{0};
+    auto worker = [&](u32 tid) {
+        MoebiusSegments ms(P);
+        std::vector<i8> mu(S);
+        for (u64 b; (b = next_block.fetch_add(1)) < n_blocks; ) {
+            u64 A = 1 + b * block_len, B = std::min(A + block_len, limit + 1);
+            ms.start(A, B);
+            for (u64 sl = A; sl < B; sl += S) {
+                u32 len = (u32)std::min<u64>(S, B - sl);
+                ms.next(mu.data(), len);
+                i64 run = 0;
+                size_t c = std::lower_bound(cps.begin(), cps.end(), sl) - cps.begin();
+                for (u32 i = 0; i < len; ++i) {
+                    run += mu[i];
+                    for (; c < cps.size() && cps[c] == sl + i; ++c) part[tid][c] += run;
+                }
+                for (; c < cps.size(); ++c) part[tid][c] += run;     // points past this segment
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (u32 i = 0; i < num_threads; ++i) threads.emplace_back(worker, i);
+    for (auto& t : threads) t.join();
+    std::vector<i64> out(cps.size(), 0);
+    for (auto& v : part)
+        for (size_t k = 0; k < cps.size(); ++k) out[k] += v[k];
+    return out;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    using namespace std::chrono;
+
+    u64 x = argc > 1 ? (u64)std::strtod(argv[1], nullptr) : 1'000'000'000'000ULL;
+    u64 vlim = argc > 2 ? (u64)std::strtod(argv[2], nullptr) : 1'000'000'000ULL;
+    if (x < 1 || x > 10'000'000'000'000'000ULL) { std::cerr << "need 1 <= x <= 1e16\n"; return 1; }
+
+    u32 num_threads = std::thread::hardware_concurrency();
+    if (num_threads == 0) num_threads = 4;
+
+    std::cout << "=== Mertens Function M(x) (x = " << x << ") ===\n";
+    std::cout << "Threads: " << num_threads << "\n\n";
+
+    auto t0 = high_resolution_clock::now();
+    auto r = mertens(x, num_threads);
+    auto t1 = high_resolution_clock::now();
+
+    std::cout << "u = " << r.u << ", table to " << r.q0 << ", sieve range (" << r.q0 << ", " << r.hi_a << "]\n";
+    std::cout << "Table:          " << r.table_s * 1000 << " ms\n";
+    std::cout << "Phase B:        " << r.phase_b_s * 1000 << " ms\n";
+    std::cout << "Phase A:        " << r.phase_a_s * 1000 << " ms\n";
+    std::cout << "────────────────────────\n";
+    std::cout << "Total:          " << duration<double, std::milli>(t1 - t0).count() << " ms\n\n";
+    std::cout << "M(" << x << ") = " << r.value << "\n";
+
+    bool ok = true;
+    if (vlim) {
+        std::vector<u64> cps;
+        for (u64 p = 10; p <= vlim; p *= 10) cps.push_back(p);
+        for (u64 v : {1ULL, 2ULL, 39ULL, 1000003ULL, 123456789ULL, 999999937ULL})
+            if (v <= vlim) cps.push_back(v);
+        cps.push_back(vlim);
+        if (x <= vlim) cps.push_back(x);
+        std::sort(cps.begin(), cps.end());
+        cps.erase(std::unique(cps.begin(), cps.end()), cps.end());
+
+        auto t2 = high_resolution_clock::now();
+        auto direct = mertens_direct(vlim, cps, num_threads);
+        auto t3 = high_resolution_clock::now();
+        u64 bad = 0;
+        for (size_t k = 0; k < cps.size(); ++k)
+            if (mertens(cps[k], num_threads).value != direct[k]) {
+                ++bad;
+                std::cout << "  mismatch at " << cps[k] << ": direct " << direct[k] << "\n";
+            }
+        ok = !bad;
+        std::cout << "Verify (direct sum to " << vlim << ", " << cps.size() << " points, "
+                  << duration<double, std::milli>(t3 - t2).count() << " ms): "
+                  << (ok ? "OK" : "MISMATCH") << "\n";
+    }
+
+    double ms = duration<double, std::milli>(t1 - t0).count();
+    std::cout << "\nThroughput: " << (u64)((double)r.hi_a / (ms > 0 ? ms : 1) / 1000) << " million sieve values/sec\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,358 @@
+// c-primes-safe-primes.cpp
+// Sophie Germain / safe prime search: q and 2q+1 sieved together in one segment pass
+// Compile: g++ -O3 -march=native -mavx2 -pthread -std=c++17 c-primes-safe-primes.cpp -o c-primes-safe-primes
+// Usage:   c-primes-safe-primes [n]   (Sophie Germain primes q <= n, safe primes 2q+1 <= 2n+1)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define HAS_AVX2 1
+#else
+#define HAS_AVX2 0
+#endif
+
+using u64 = uint64_t;
+using u32 = uint32_t;
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+inline int ctz64(u64 x) { unsigned long i; _BitScanForward64(&i, x); return i; }
+inline int popcnt64(u64 x) { return (int)__popcnt64(x); }
+inline u64 mul_wide(u64 a, u64 b, u64* hi) { return _umul128(a, b, hi); }
+#else
+inline int ctz64(u64 x) { return __builtin_ctzll(x); }
+inline int popcnt64(u64 x) { return __builtin_popcountll(x); }
+inline u64 mul_wide(u64 a, u64 b, u64* hi) {
+    unsigned __int128 t = (unsigned __int128)a * b;
+    *hi = (u64)(t >> 64);
+    return (u64)t;
+}
+#endif
+
+// Base sieve
+std::vector<u32> base_sieve(u32 n) {
+    u32 h = n / 2 + 1;
+    std::vector<u64> b((h + 63) >> 6, ~0ULL);
+    b[0] ^= 1;
+    for (u32 i = 1, L = (u32)std::sqrt(n) / 2; i <= L; ++i)
+        if (b[i >> 6] >> (i & 63) & 1)
+            for (u32 j = 2*i*(i+1), s = 2*i+1; j < h; j += s)
+                b[j >> 6] &= ~(1ULL << (j & 63));
+    std::vector<u32> P{2};
+    for (u32 i = 0; i < b.size(); ++i)
+        for (auto w = b[i]; w; w &= w - 1) {
+            u32 v = ((i << 6) + ctz64(w)) * 2 + 1;
+            if (v > 1 && v <= n) P.push_back(v);
+        }
+    return P;
+}
+
+#if HAS_AVX2
+inline void avx2_fill_ones(u64* ptr, size_t words) {
+    if (words == 0) return;
+    __m256i ones = _mm256_set1_epi64x(-1LL);
+    size_t i = 0;
+    for (; i + 4 <= words; i += 4)
+        _mm256_storeu_si256((__m256i*)(ptr + i), ones);
+    for (; i < words; ++i)
+        ptr[i] = ~0ULL;
+}
+#endif
+
+// ============================================================================
+// Deterministic Miller-Rabin for n < 2^63 (chain extension past the bitmap)
+// ============================================================================
+// Montgomery form with R = 2^64 keeps the hot loop free of 128-bit division;
+// n < 2^63 means t + m*n cannot overflow 128 bits. R^2 mod n comes from 64
+// modular doublings of R mod n, so nothing divides a 128-bit value.
+struct Mont64 {
+    u64 n, ni, one, r2;
+    explicit Mont64(u64 n_) : n(n_) {
+        u64 inv = n;                        // n * inv = 1 (mod 2^64), Newton
+        for (int i = 0; i < 5; ++i) inv *= 2 - n * inv;
+        ni = 0 - inv;
+        one = (0 - n) % n;
+        r2 = one;
+        for (int i = 0; i < 64; ++i) r2 = r2 >= n - r2 ? r2 - (n - r2) : r2 + r2;
+    }
+    u64 mul(u64 a, u64 b) const {
+        u64 th, mh;
+        u64 tl = mul_wide(a, b, &th);
+        mul_wide(tl * ni, n, &mh);
+        u64 r = th + mh + (tl != 0);        // tl + low(m*n) = 0 (mod 2^64)
+        return r >= n ? r - n : r;
+    }
+    u64 to(u64 a) const { return mul(a % n, r2); }
+};
+
+bool is_prime_mr(u64 n) {
+    if (n < 2) return false;
+    for (u64 p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37})
+        if (n % p == 0) return n == p;
+    if (n < 41 * 41) return true;
+    u64 d = n - 1;
+    int s = ctz64(d);
+    d >>= s;
+    Mont64 M(n);
+    u64 one = M.one, neg = n - M.one;
+    for (u64 a : {2, 325, 9375, 28178, 450775, 9780504, 1795265022}) {
+        u64 x = M.to(a);
+        if (x == 0) continue;
+        u64 b = x;
+        x = one;
+        for (u64 e = d; e; e >>= 1, b = M.mul(b, b))
+            if (e & 1) x = M.mul(x, b);
+        if (x == one || x == neg) continue;
+        bool composite = true;
+        for (int r = 1; r < s && composite; ++r)
+            composite = (x = M.mul(x, x)) != neg;
+        if (composite) return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Cunningham chains of the first kind: q, 2q+1, 4q+3, ...
+// ============================================================================
+constexpr int MAX_CHAIN = 16;
+
+// Length of the chain starting at a Sophie Germain prime q (so >= 2).
+inline int chain_length(u64 q) {
+    int len = 2;
+    for (u64 x = 2 * q + 1; len < MAX_CHAIN && x < (1ULL << 62) && is_prime_mr(2 * x + 1); x = 2 * x + 1)
+        ++len;
+    return len;
+}
+
+// q starts a chain unless (q-1)/2 is itself prime.
+inline bool chain_head(u64 q) {
+    if (q == 2) return true;
+    u64 h = (q - 1) >> 1;
+    if (h == 2) return false;
+    return !(h & 1) || !is_prime_mr(h);
+}
+
+struct Stats {
+    u64 sg = 0;                         // Sophie Germain primes found
+    u64 heads[MAX_CHAIN + 1] = {};      // chain heads by length
+    u64 best_head = 0;                  // smallest head of the longest chain
+    int best_len = 0;
+    u64 top[5] = {};                    // five largest q seen (ascending)
+
+    void add(u64 q) {
+        ++sg;
+        std::copy(top + 1, top + 5, top);
+        top[4] = q;
+        if (!chain_head(q)) return;
+        int len = chain_length(q);
+        ++heads[len];
+        if (len > best_len || (len == best_len && q < best_head)) { best_len = len; best_head = q; }
+    }
+
+    void merge(const Stats& o) {
+        sg += o.sg;
+        for (int i = 0; i <= MAX_CHAIN; ++i) heads[i] += o.heads[i];
+        if (o.best_len > best_len || (o.best_len == best_len && o.best_head < best_head)) {
+            best_len = o.best_len; best_head = o.best_head;
+        }
+        u64 all[10];
+        std::copy(top, top + 5, all);
+        std::copy(o.top, o.top + 5, all + 5);
+        std::sort(all, all + 10);
+        std::copy(all + 5, all + 10, top);
+    }
+};
+
+// ============================================================================
+// Coupled segment sieve
+// ============================================================================
+// Bit i of a segment stands for the odd q = lo + 2i, as in the plain sieve.
+// Every base prime p clears two residue classes: q = 0 (mod p), which kills
+// composite q, and q = (p-1)/2 (mod p), which kills q whose partner 2q+1 is a
+// multiple of p. With base primes up to sqrt(2n+1) the survivors are exactly
+// the Sophie Germain primes, so no pair lookup or second pass is needed.
+constexpr u32 S = 1 << 18;  // 256K odds per segment
+constexpr u32 SEG_WORDS = (S + 63) >> 6;
+
+inline void cross(u64* seg, u64 idx, u64 p, u64 seg_size) {
+    // Unrolled for small primes
+    if (p < 64) {
+        while (idx + 4 * p <= seg_size) {
+            seg[idx >> 6] &= ~(1ULL << (idx & 63)); idx += p;
+            seg[idx >> 6] &= ~(1ULL << (idx & 63)); idx += p;
+            seg[idx >> 6] &= ~(1ULL << (idx & 63)); idx += p;
+            seg[idx >> 6] &= ~(1ULL << (idx & 63)); idx += p;
+        }
+    }
+    while (idx < seg_size) {
+        seg[idx >> 6] &= ~(1ULL << (idx & 63));
+        idx += p;
+    }
+}
+
+void sieve_segment(u64* seg, u64 lo, u64 hi, const std::vector<u32>& B) {
+    u64 seg_size = ((hi - lo) >> 1) + 1;
+    u64 seg_words = (seg_size + 63) >> 6;
+
+    #if HAS_AVX2
+    avx2_fill_ones(seg, seg_words);
+    #else
+    std::fill(seg, seg + seg_words, ~0ULL);
+    #endif
+    seg[seg_words - 1] &= ~0ULL >> ((seg_words << 6) - seg_size);
+
+    for (size_t i = 1; i < B.size(); ++i) {
+        u64 p = B[i];
+
+        // q composite
+        u64 start;
+        if (p * p >= lo) {
+            start = p * p;
+        } else {
+            start = ((lo + p - 1) / p) * p;
+            if (!(start & 1)) start += p;
+        }
+        if (start <= hi) cross(seg, (start - lo) >> 1, p, seg_size);
+
+        // 2q+1 composite: q = r (mod p), skipping q = r itself (2q+1 = p)
+        u64 r = p >> 1;
+        u64 m = lo % p;
+        start = lo + (r >= m ? r - m : r + p - m);
+        if (!(start & 1)) start += p;
+        if (start == r) start += 2 * p;
+        if (start <= hi) cross(seg, (start - lo) >> 1, p, seg_size);
+    }
+}
+
+// Reference: list primes up to 2n+1, then test every pair.
+u64 count_pairs_naive(u64 n) {
+    auto P = base_sieve((u32)(2 * n + 1));
+    std::vector<bool> is_p(2 * n + 2, false);
+    for (u32 p : P) is_p[p] = true;
+    u64 c = 0;
+    for (u32 p : P) {
+        if (p > n) break;
+        c += is_p[2 * (u64)p + 1];
+    }
+    return c;
+}
+
+int main(int argc, char** argv) {
+    using namespace std::chrono;
+
+    u64 n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000'000ULL;
+    if (n < 2) n = 2;
+
+    u32 num_threads = std::thread::hardware_concurrency();
+    if (num_threads == 0) num_threads = 4;
+
+    std::cout << "=== Sophie Germain / Safe Prime Search (n = " << n << ") ===\n";
+    #if HAS_AVX2
+    std::cout << "AVX2: ENABLED\n";
+    #else
+    std::cout << "AVX2: DISABLED\n";
+    #endif
+    std::cout << "Threads: " << num_threads << "\n";
+    std::cout << "Segment: " << (SEG_WORDS * 8 / 1024) << " KB\n\n";
+
+    auto t0 = high_resolution_clock::now();
+
+    // Base primes cover both q <= n and 2q+1 <= 2n+1
+    auto B = base_sieve((u32)std::sqrt((double)(2 * n + 1)) + 1);
+
+    auto t1 = high_resolution_clock::now();
+
+    // Parallel sieving; q = 2 is the only even candidate
+    std::atomic<u64> next_lo{3};
+    std::vector<Stats> thread_stats(num_threads);
+
+    auto worker = [&](u32 tid) {
+        alignas(64) u64 seg[SEG_WORDS];
+        Stats& st = thread_stats[tid];
+
+        while (true) {
+            u64 lo = next_lo.fetch_add(S << 1);
+            if (lo > n) break;
+            u64 hi = std::min(lo + (S << 1) - 2, n);
+
+            sieve_segment(seg, lo, hi, B);
+
+            u64 seg_words = ((((hi - lo) >> 1) + 1) + 63) >> 6;
+            for (size_t i = 0; i < seg_words; ++i)
+                for (auto w = seg[i]; w; w &= w - 1)
+                    st.add(lo + (((i << 6) + ctz64(w)) << 1));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (u32 i = 0; i < num_threads; ++i)
+        threads.emplace_back(worker, i);
+    for (auto& t : threads)
+        t.join();
+
+    Stats total;
+    total.add(2);
+    for (auto& s : thread_stats) total.merge(s);
+
+    auto t2 = high_resolution_clock::now();
+
+    auto base_ms = duration_cast<milliseconds>(t1 - t0).count();
+    auto sieve_ms = duration_cast<milliseconds>(t2 - t1).count();
+    auto total_ms = duration_cast<milliseconds>(t2 - t0).count();
+
+    std::cout << "Base sieve:     " << base_ms << " ms\n";
+    std::cout << "Coupled sieve:  " << sieve_ms << " ms\n";
+    std::cout << "────────────────────────\n";
+    std::cout << "Total:          " << total_ms << " ms\n\n";
+
+    std::cout << "Found " << total.sg << " Sophie Germain primes up to " << n << "\n";
+    std::cout << "      " << total.sg << " safe primes up to " << 2 * n + 1 << "\n";
+    std::cout << "Last 5: ";
+    for (u64 q : total.top) if (q) std::cout << q << ' ';
+    std::cout << "\nLast 5 safe: ";
+    for (u64 q : total.top) if (q) std::cout << 2 * q + 1 << ' ';
+    std::cout << "\n\n";
+
+    std::cout << "Cunningham chains (first kind) by length, counted at their head:\n";
+    for (int len = 2; len <= MAX_CHAIN; ++len)
+        if (total.heads[len])
+            std::cout << "  length " << len << (len == MAX_CHAIN ? "+" : "") << ": " << total.heads[len] << "\n";
+    std::cout << "Longest: " << total.best_len << " starting at " << total.best_head << " (";
+    for (int i = 0, x = 0; i < total.best_len; ++i, x = 1) {
+        if (x) std::cout << ", ";
+        std::cout << (total.best_head << i) + ((1ULL << i) - 1);
+    }
+    std::cout << ")\n\n";
+
+    std::cout << "Throughput: " << (n / (total_ms ? total_ms : 1)) / 1000 << " million/sec\n";
+
+    // Cross-check a prefix against the list-and-pair approach
+    u64 vn = std::min<u64>(n, 10'000'000ULL);
+    auto t3 = high_resolution_clock::now();
+    u64 naive = count_pairs_naive(vn);
+    auto t4 = high_resolution_clock::now();
+    Stats v;
+    v.add(2);
+    alignas(64) static u64 seg[SEG_WORDS];
+    for (u64 lo = 3; lo <= vn; lo += S << 1) {
+        u64 hi = std::min(lo + (S << 1) - 2, vn);
+        sieve_segment(seg, lo, hi, B);
+        for (size_t i = 0, w_n = ((((hi - lo) >> 1) + 1) + 63) >> 6; i < w_n; ++i)
+            v.sg += popcnt64(seg[i]);
+    }
+    auto t5 = high_resolution_clock::now();
+    std::cout << "Verify n = " << vn << ": coupled " << v.sg << " ("
+              << duration_cast<milliseconds>(t5 - t4).count() << " ms), list+pair " << naive << " ("
+              << duration_cast<milliseconds>(t4 - t3).count() << " ms)"
+              << (v.sg == naive ? "  OK\n" : "  MISMATCH\n");
+    return v.sg == naive ? 0 : 1;
+}
@@ -1,6 +1,7 @@
 // c-primes-simd-1e9.cpp
 // AVX2-accelerated segmented sieve for n = 1,000,000,000
 // Compile: g++ -O3 -march=native -mavx2 -std=c++17 c-primes-simd-1e9.cpp -o c-primes-simd-1e9
+// Usage: c-primes-simd-1e9 [--bench]   (--bench adds the extractor benchmark after the sieve)
 
 #include <algorithm>
 #include <array>
@@ -18,8 +19,15 @@
 #define HAS_AVX2 0
 #endif
 
+#if defined(__AVX512F__)
+#define HAS_AVX512 1
+#else
+#define HAS_AVX512 0
+#endif
+
 using u64 = uint64_t;
 using u32 = uint32_t;
+using u8  = uint8_t;
 
 // Cross-platform intrinsics
 #if defined(_MSC_VER)
@@ -110,13 +118,152 @@ inline u64 avx2_popcount_segment(const u64* ptr, size_t words) {
 }
 #endif
 
+// ============================================================================
+// Medium-prime crossing on the mod-30 wheel
+// ============================================================================
+// A plain odd-only stride walks p*k for every odd k, but 1/3 of those k are
+// multiples of 3 and 1/5 multiples of 5, already crossed by the smaller
+// primes. Walking only k coprime to 30 keeps 8 of every 15: the k gaps repeat
+// 6,4,2,4,2,4,6,2, i.e. bit gaps of p * WHEEL30_GAP, 15p bits per turn. Each
+// prime carries its next bit index (relative to the segment) and wheel state
+// across segments. Whole turns are 8 writes at fixed offsets from the state's
+// row of WHEEL30_OFF; only the partial turn at the segment end steps states.
+constexpr u32 MEDIUM_MIN = 64;          // below: dense stride loop, few turns fit
+constexpr u8 WHEEL30_GAP[8] = {3, 2, 1, 2, 1, 2, 3, 1};
+constexpr u8 WHEEL30_RES[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+
+// WHEEL30_OFF[s][j]: offset of a turn's j-th write, in units of p, from state s
+constexpr std::array<std::array<u8, 8>, 8> WHEEL30_OFF = [] {
+    std::array<std::array<u8, 8>, 8> t{};
+    for (u32 s = 0; s < 8; ++s)
+        for (u32 j = 1; j < 8; ++j)
+            t[s][j] = (u8)(t[s][j - 1] + WHEEL30_GAP[(s + j - 1) & 7]);
+    return t;
+}();
+
+// Wheel state of k, gcd(k, 30) = 1
+inline u8 wheel30_state(u64 k) {
+    u8 s = 0;
+    while (WHEEL30_RES[s] != k % 30) ++s;
+    return s;
+}
+
+inline void cross_wheel30(u64* seg, u64 len, u64 p, u32& next, u8& state) {
+    const auto& o = WHEEL30_OFF[state];
+    const u64 o1 = o[1] * p, o2 = o[2] * p, o3 = o[3] * p, o4 = o[4] * p;
+    const u64 o5 = o[5] * p, o6 = o[6] * p, o7 = o[7] * p, turn = 15 * p;
+    auto clear = [seg](u64 i) { seg[i >> 6] &= ~(1ULL << (i & 63)); };
+    u64 i = next;
+    for (; i + o7 < len; i += turn) {
+        clear(i);      clear(i + o1); clear(i + o2); clear(i + o3);
+        clear(i + o4); clear(i + o5); clear(i + o6); clear(i + o7);
+    }
+    u8 s = state;
+    for (; i < len; i += WHEEL30_GAP[s] * p, s = (s + 1) & 7)
+        clear(i);
+    next = (u32)(i - len);
+    state = s;
+}
+
+// ============================================================================
+// Prime extraction: segment bitmap -> u32 values
+// ============================================================================
+// Bit i of a segment starting at odd lo is the number lo + 2i. The scalar loop
+// pays a dependent ctz / clear-lowest chain and a mispredicted exit per word.
+// The batch decoders instead handle a fixed chunk per step: they write a full
+// vector of candidate values and advance the output by the chunk's popcount,
+// so each word costs the same regardless of density. AVX-512 compresses 16
+// lane values by a 16-bit mask (VPCOMPRESSD). Otherwise an 8-bit LUT supplies
+// the 2i offsets of each byte, widened with AVX2 and added to the base in-lane.
+// Output needs EXTRACT_SLACK u32 of room past the last prime.
+constexpr u32 EXTRACT_SLACK = 16;
+
+struct ByteLUT {
+    alignas(64) u8 off[256][8];     // 2 * bit position of each set bit, in order
+    u8 cnt[256];
+};
+
+const ByteLUT g_lut = [] {
+    ByteLUT t{};
+    for (u32 b = 0; b < 256; ++b) {
+        u32 k = 0;
+        for (u32 i = 0; i < 8; ++i)
+            if (b >> i & 1) t.off[b][k++] = (u8)(2 * i);
+        t.cnt[b] = (u8)k;
+    }
+    return t;
+}();
+
+u32 extract_scalar(const u64* seg, size_t words, u32 lo, u32* out) {
+    u32 n = 0;
+    for (size_t i = 0; i < words; ++i)
+        for (auto w = seg[i]; w; w &= w - 1)
+            out[n++] = lo + (u32)(((i << 6) + ctz64(w)) << 1);
+    return n;
+}
+
+u32 extract_lut(const u64* seg, size_t words, u32 lo, u32* out) {
+    u32* o = out;
+    for (size_t i = 0; i < words; ++i) {
+        u64 w = seg[i];
+        if (!w) continue;
+        u32 base = lo + (u32)(i << 7);
+        for (u32 k = 0; k < 8; ++k, base += 16) {
+            u32 b = (u32)(w >> (8 * k)) & 0xFF;
+#if HAS_AVX2
+            __m256i d = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)g_lut.off[b]));
+            _mm256_storeu_si256((__m256i*)o, _mm256_add_epi32(d, _mm256_set1_epi32((int)base)));
+#else
+            for (u32 j = 0; j < 8; ++j) o[j] = base + g_lut.off[b][j];
+#endif
+            o += g_lut.cnt[b];
+        }
+    }
+    return (u32)(o - out);
+}
+
+#if HAS_AVX512
+u32 extract_avx512(const u64* seg, size_t words, u32 lo, u32* out) {
+    const __m512i lane = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+    const __m512i step = _mm512_set1_epi32(32);
+    u32* o = out;
+    for (size_t i = 0; i < words; ++i) {
+        u64 w = seg[i];
+        if (!w) continue;
+        __m512i v = _mm512_add_epi32(_mm512_set1_epi32((int)(lo + (u32)(i << 7))), lane);
+        for (u32 k = 0; k < 4; ++k) {
+            __mmask16 m = (__mmask16)(w >> (16 * k));
+            _mm512_storeu_si512(o, _mm512_maskz_compress_epi32(m, v));
+            o += popcnt64(m);
+            v = _mm512_add_epi32(v, step);
+        }
+    }
+    return (u32)(o - out);
+}
+#endif
+
+// Without AVX2 the LUT's eight scalar stores per byte lose to the ctz loop
+inline u32 extract(const u64* seg, size_t words, u32 lo, u32* out) {
+#if HAS_AVX512
+    return extract_avx512(seg, words, lo, out);
+#elif HAS_AVX2
+    return extract_lut(seg, words, lo, out);
+#else
+    return extract_scalar(seg, words, lo, out);
+#endif
+}
+
 // ============================================================================
 // Main SIMD Sieve
 // ============================================================================
 
-int main() {
+int main(int argc, char** argv) {
     using namespace std::chrono;
     
+    bool bench = false;
+    for (int i = 1; i < argc; ++i)
+        if (strcmp(argv[i], "--bench") == 0) bench = true;
+    
     constexpr u64 n = 1'000'000'000ULL;
     constexpr u32 S = 1 << 18;  // 256K odds = 32KB segment (L1 friendly)
     constexpr u32 SEG_WORDS = (S + 63) >> 6;
@@ -127,6 +274,8 @@ int main() {
     #else
     std::cout << "AVX2: DISABLED (scalar fallback)\n";
     #endif
+    std::cout << "Extraction: " << (HAS_AVX512 ? "AVX-512 VPCOMPRESSD" : HAS_AVX2 ? "byte LUT + AVX2" : "scalar ctz") << "\n";
+    std::cout << "Crossing: p < " << MEDIUM_MIN << " odd stride, larger p mod-30 wheel (8 of 15 odd multiples)\n";
     std::cout << "Segment size: " << (S * 2) << " integers (" << (SEG_WORDS * 8) << " bytes)\n\n";
     
     auto t0 = high_resolution_clock::now();
@@ -139,19 +288,30 @@ int main() {
     
     auto t1 = high_resolution_clock::now();
     
-    // Precompute first odd multiple >= p^2 for each base prime (offset within segment)
+    // Dense primes restart from p^2 or lo each segment; medium primes carry
+    // their wheel position, starting at p^2 (k = p, coprime to 30)
     struct PrimeInfo {
         u32 prime;
         u32 next_idx;  // Next composite index within current segment
+        u8 wheel;      // Wheel state of that composite's cofactor
     };
     std::vector<PrimeInfo> primes_info;
     primes_info.reserve(B.size());
     for (size_t i = 1; i < B.size(); ++i) {  // Skip 2
-        primes_info.push_back({B[i], 0});
+        u32 p = B[i];
+        if (p < MEDIUM_MIN) primes_info.push_back({p, 0, 0});
+        else primes_info.push_back({p, (u32)(((u64)p * p - 3) >> 1), wheel30_state(p)});
     }
+    size_t first_medium = 0;
+    while (first_medium < primes_info.size() && primes_info[first_medium].prime < MEDIUM_MIN) ++first_medium;
     
-    // Aligned segment buffer
+    // Aligned segment buffer, extracted primes and, with --bench, a mid-range
+    // snapshot for the extraction benchmark
     alignas(64) u64 seg[SEG_WORDS];
+    std::vector<u32> primes(S + EXTRACT_SLACK);
+    std::vector<u64> snapshot;
+    u32 snapshot_lo = 0;
+    double extract_ms = 0;
     
     // Result tracking
     std::array<u64, 5> ring{};
@@ -175,9 +335,9 @@ int main() {
         std::fill(seg, seg + seg_words, ~0ULL);
         #endif
         
-        // Step 2: Mark composites for each base prime
-        for (auto& pi : primes_info) {
-            u64 p = pi.prime;
+        // Step 2: Mark composites for each dense base prime
+        for (size_t j = 0; j < first_medium; ++j) {
+            u64 p = primes_info[j].prime;
             u64 p2 = p * p;
             
             // Find starting point in this segment
@@ -194,18 +354,16 @@ int main() {
             // Mark all odd multiples of p in [start, hi]
             u64 idx = (start - lo) >> 1;
             
-            // Unrolled marking for small primes (hot path)
-            if (p < 64) {
-                while (idx + 4 * p <= seg_size) {
-                    seg[idx >> 6] &= ~(1ULL << (idx & 63));
-                    idx += p;
-                    seg[idx >> 6] &= ~(1ULL << (idx & 63));
-                    idx += p;
-                    seg[idx >> 6] &= ~(1ULL << (idx & 63));
-                    idx += p;
-                    seg[idx >> 6] &= ~(1ULL << (idx & 63));
-                    idx += p;
-                }
+            // Unrolled marking (hot path)
+            while (idx + 4 * p <= seg_size) {
+                seg[idx >> 6] &= ~(1ULL << (idx & 63));
+                idx += p;
+                seg[idx >> 6] &= ~(1ULL << (idx & 63));
+                idx += p;
+                seg[idx >> 6] &= ~(1ULL << (idx & 63));
+                idx += p;
+                seg[idx >> 6] &= ~(1ULL << (idx & 63));
+                idx += p;
             }
             
             // Remainder
@@ -215,13 +373,23 @@ int main() {
             }
         }
         
-        // Step 3: Extract primes (Kernighan bit-clear + ctz)
-        for (size_t i = 0; i < seg_words; ++i) {
-            for (auto w = seg[i]; w; w &= w - 1) {
-                u64 v = lo + (((i << 6) + ctz64(w)) << 1);
-                if (v <= n) add(v);
-            }
+        // ... and the medium ones, on the mod-30 wheel
+        for (size_t j = first_medium; j < primes_info.size(); ++j) {
+            auto& pi = primes_info[j];
+            cross_wheel30(seg, seg_size, pi.prime, pi.next_idx, pi.wheel);
         }
+        
+        // Step 3: Extract primes in batches (tail bits past n cleared first)
+        if (seg_size & 63) seg[seg_words - 1] &= (1ULL << (seg_size & 63)) - 1;
+        if (bench && snapshot.empty() && lo >= n / 2 && seg_words == SEG_WORDS) {
+            snapshot.assign(seg, seg + SEG_WORDS);
+            snapshot_lo = (u32)lo;
+        }
+        auto e0 = high_resolution_clock::now();
+        u32 m = extract(seg, seg_words, (u32)lo, primes.data());
+        extract_ms += duration<double, std::milli>(high_resolution_clock::now() - e0).count();
+        cnt += m;
+        for (u32 j = m > 5 ? m - 5 : 0; j < m; ++j) ring[pos++ % 5] = primes[j];
     }
     
     auto t3 = high_resolution_clock::now();
@@ -234,7 +402,7 @@ int main() {
     
     std::cout << "Base sieve:  " << base_ms << " ms\n";
     std::cout << "Preparation: " << prep_ms << " ms\n";
-    std::cout << "Main sieve:  " << sieve_ms << " ms\n";
+    std::cout << "Main sieve:  " << sieve_ms << " ms (extraction " << (u64)extract_ms << " ms)\n";
     std::cout << "─────────────────────\n";
     std::cout << "Total:       " << total_ms << " ms\n\n";
     
@@ -246,7 +414,35 @@ int main() {
     std::cout << "\n\n";
     
     std::cout << "Throughput: " << (n / total_ms) / 1000 << " million integers/sec\n";
-    std::cout << "Prime rate:  " << (cnt / total_ms) / 1000 << " million primes/sec\n";
+    std::cout << "Prime rate:  " << (cnt / total_ms) / 1000 << " million primes/sec\n\n";
+    
+    // Extraction benchmark: each decoder on the same mid-range segment (--bench)
+    bool ok = true;
+    if (bench) {
+        struct Extractor { const char* name; u32 (*fn)(const u64*, size_t, u32, u32*); };
+        std::vector<Extractor> ex = {{"scalar ctz", extract_scalar}, {"byte LUT", extract_lut}};
+        #if HAS_AVX512
+        ex.push_back({"VPCOMPRESSD", extract_avx512});
+        #endif
+        constexpr int REPS = 400;
+        std::vector<u32> ref(S + EXTRACT_SLACK), got(S + EXTRACT_SLACK);
+        u32 ref_n = extract_scalar(snapshot.data(), SEG_WORDS, snapshot_lo, ref.data());
+        volatile u64 sink = 0;                          // keeps the timed output live
+        for (auto& e : ex) {
+            u32 k = e.fn(snapshot.data(), SEG_WORDS, snapshot_lo, got.data());
+            ok &= k == ref_n && std::equal(ref.begin(), ref.begin() + k, got.begin());
+            auto b0 = high_resolution_clock::now();
+            for (int r = 0; r < REPS; ++r) {
+                k = e.fn(snapshot.data(), SEG_WORDS, snapshot_lo, got.data());
+                sink = sink + k + got[k - 1];
+            }
+            double sec = duration<double>(high_resolution_clock::now() - b0).count();
+            std::cout << "Extract " << e.name << ": " << std::string(12 - std::strlen(e.name), ' ')
+                      << (u64)(REPS * (double)k / sec / 1e6) << " million primes/sec, "
+                      << REPS * (double)k * 4 / sec / 1e9 << " GB/s out\n";
+        }
+        std::cout << "Verify extractors: " << (ok ? "OK" : "MISMATCH") << "\n";
+    }
     
-    return 0;
+    return ok ? 0 : 1;
 }
@@ -1,6 +1,7 @@
 // c-primes-simd-parallel-1e9.cpp
 // Ultimate: AVX2 + Multi-threaded segmented sieve
 // Compile: g++ -O3 -march=native -mavx2 -pthread -std=c++17 c-primes-simd-parallel-1e9.cpp -o c-primes-simd-parallel-1e9
+// Usage: c-primes-simd-parallel-1e9 [--bench]   (--bench adds the microbenchmarks after the sieve)
 
 #include <algorithm>
 #include <array>
@@ -8,7 +9,10 @@
 #include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
+#include <iomanip>
 #include <iostream>
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -25,8 +29,12 @@ using u32 = uint32_t;
 #if defined(_MSC_VER)
 #include <intrin.h>
 inline int ctz64(u64 x) { unsigned long i; _BitScanForward64(&i, x); return i; }
+inline u64 mulhi64(u64 a, u64 b) { return __umulh(a, b); }
+inline void prefetch_w(const void* p) { _mm_prefetch((const char*)p, _MM_HINT_T0); }
 #else
 inline int ctz64(u64 x) { return __builtin_ctzll(x); }
+inline u64 mulhi64(u64 a, u64 b) { return (u64)(((unsigned __int128)a * b) >> 64); }
+inline void prefetch_w(const void* p) { __builtin_prefetch(p, 1); }
 #endif
 
 // Base sieve
@@ -47,21 +55,293 @@ std::vector<u32> base_sieve(u32 n) {
     return P;
 }
 
+// Dense primes (p < 64) as rotating word masks
+// Bit j of a segment starting at odd lo is the number 2k + 1 with
+// k = (lo - 1) / 2 + j, a multiple of p exactly when k = (p - 1) / 2 (mod p).
+// Because gcd(64, p) = 1, the words of that pattern repeat with period p, so
+// each small prime keeps its p masks in sequence order (seq[i] holds the
+// pattern from bit 64i mod p) and a segment only needs its starting index
+// into the cycle. The fill stores the AND of all 17 sequences, 4 words per
+// AVX2 step, in place of the ones fill and ~p/64 single-bit RMWs per word per
+// prime. The masks also strike p itself, which the caller restores.
+constexpr u32 SMALL_PRIMES[] = {3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61};
+constexpr u32 NUM_SMALL = sizeof(SMALL_PRIMES) / sizeof(SMALL_PRIMES[0]);
+
+struct SmallPrimeMasks {
+    std::vector<u64> seq[NUM_SMALL];    // 2p + 4 words: loads at i..i+3 never wrap
+    u32 inv64[NUM_SMALL];               // 64^-1 mod p
+
+    SmallPrimeMasks() {
+        for (u32 q = 0; q < NUM_SMALL; ++q) {
+            u32 p = SMALL_PRIMES[q];
+            seq[q].resize(2 * p + 4);
+            for (u32 i = 0; i < 2 * p + 4; ++i) {
+                u64 w = ~0ULL;
+                for (u32 b = 0; b < 64; ++b)
+                    if ((64 * i + b) % p == (p - 1) / 2) w &= ~(1ULL << b);
+                seq[q][i] = w;
+            }
+            for (u32 t = 1; t < p; ++t)
+                if (64 * t % p == 1) inv64[q] = t;
+        }
+    }
+
+    // seg[0, words) = odds from lo with every multiple of p < 64 cleared
+    void fill(u64* seg, size_t words, u64 lo) const {
+        u64 k0 = (lo - 1) >> 1;
+        u32 idx[NUM_SMALL];
+        for (u32 q = 0; q < NUM_SMALL; ++q) {
+            u32 p = SMALL_PRIMES[q];
+            idx[q] = (u32)(k0 % p) * inv64[q] % p;
+        }
+        size_t w = 0;
+        #if HAS_AVX2
+        for (; w + 4 <= words; w += 4) {
+            __m256i acc = _mm256_set1_epi64x(-1LL);
+            for (u32 q = 0; q < NUM_SMALL; ++q) {
+                u32 p = SMALL_PRIMES[q];
+                acc = _mm256_and_si256(acc, _mm256_loadu_si256((const __m256i*)(seq[q].data() + idx[q])));
+                idx[q] += 4 % p;                    // p = 3 steps by 1
+                if (idx[q] >= p) idx[q] -= p;
+            }
+            _mm256_storeu_si256((__m256i*)(seg + w), acc);
+        }
+        #endif
+        for (; w < words; ++w) {
+            u64 acc = ~0ULL;
+            for (u32 q = 0; q < NUM_SMALL; ++q) {
+                acc &= seq[q][idx[q]];
+                if (++idx[q] == SMALL_PRIMES[q]) idx[q] = 0;
+            }
+            seg[w] = acc;
+        }
+        for (u32 p : SMALL_PRIMES)                  // the masks struck p itself
+            if (p >= lo && ((p - lo) >> 1) < words * 64)
+                seg[(p - lo) >> 7] |= 1ULL << (((p - lo) >> 1) & 63);
+    }
+};
+
+// Bit index, from lo, of p's first odd multiple >= max(p^2, lo); it may
+// lie past the segment, and then carries into the following ones
+inline u64 first_index(u64 p, u64 lo) {
+    u64 start;
+    if (p * p >= lo) start = p * p;
+    else {
+        start = ((lo + p - 1) / p) * p;
+        if (!(start & 1)) start += p;
+    }
+    return (start - lo) >> 1;
+}
+
+// Reseeding
+// A segment taken out of order needs its first multiple of every base prime
+// from scratch: ~3,400 64-bit divides per segment at 1e9, ~200k at 1e13.
+// Each prime gets a libdivide-style branchfree reciprocal instead. With
+// s = floor(log2 p) and m = floor(2^(65+s) / p) - 2^64 + 1,
+//   q = mulhi(m, x),  floor(x / p) = (q + ((x - q) >> 1)) >> s
+// for every 64-bit x. AVX2 has no 64-bit high multiply, so it is built from
+// four 32x32 products; four primes still reseed in about the time of one
+// hardware divide. That makes reseeding cheap only while base primes are few:
+// at 1e13 nearly all ~220k of them miss a 512K-number segment, so a full
+// reseed still costs about a fifth of crossing that segment. There it is the
+// work-stealing layout below, carrying K from one segment to the next, that
+// keeps reseeds rare; reciprocals just shrink the ones that remain.
+struct Reciprocals {
+    std::vector<u64> magic;
+    std::vector<u32> shift;
+
+    Reciprocals(const u32* P, size_t count) : magic(count), shift(count) {
+        for (size_t i = 0; i < count; ++i) {
+            u64 d = P[i];                           // odd, 3 <= d < 2^32
+            u32 s = 0;
+            while (d >> (s + 1)) ++s;
+            // 2^(65+s) / d by 32-bit limbs; the top quotient limb is 1 (dropped)
+            u64 r = (1ULL << (s + 1)) % d;
+            u64 q1 = (r << 32) / d;
+            r = (r << 32) % d;
+            u64 q0 = (r << 32) / d;
+            magic[i] = ((q1 << 32) | q0) + 1;
+            shift[i] = s;
+        }
+    }
+};
+
+inline u64 div_magic(u64 x, u64 m, u32 s) {
+    u64 q = mulhi64(m, x);
+    return (((x - q) >> 1) + q) >> s;
+}
+
 #if HAS_AVX2
-inline void avx2_fill_ones(u64* ptr, size_t words) {
-    if (words == 0) return;
-    __m256i ones = _mm256_set1_epi64x(-1LL);
-    size_t i = 0;
-    for (; i + 4 <= words; i += 4)
-        _mm256_storeu_si256((__m256i*)(ptr + i), ones);
-    for (; i < words; ++i)
-        ptr[i] = ~0ULL;
+inline __m256i mulhi_epu64(__m256i a, __m256i b) {
+    const __m256i lo32 = _mm256_set1_epi64x(0xFFFFFFFF);
+    __m256i ah = _mm256_srli_epi64(a, 32), bh = _mm256_srli_epi64(b, 32);
+    __m256i ll = _mm256_mul_epu32(a, b), lh = _mm256_mul_epu32(a, bh);
+    __m256i hl = _mm256_mul_epu32(ah, b), hh = _mm256_mul_epu32(ah, bh);
+    __m256i mid = _mm256_add_epi64(lh, _mm256_srli_epi64(ll, 32));
+    __m256i mid2 = _mm256_add_epi64(hl, _mm256_and_si256(mid, lo32));
+    return _mm256_add_epi64(_mm256_add_epi64(hh, _mm256_srli_epi64(mid, 32)), _mm256_srli_epi64(mid2, 32));
 }
 #endif
 
-int main() {
+// K[i] = first_index(P[i], lo); VEC takes four primes per step
+template <bool VEC>
+void reseed(u64* K, u64 lo, const u32* P, const Reciprocals& R, size_t count) {
+    size_t i = 0;
+    #if HAS_AVX2
+    if (VEC) {
+        const __m256i one = _mm256_set1_epi64x(1), vlo = _mm256_set1_epi64x(lo);
+        for (; i + 4 <= count; i += 4) {
+            __m256i p = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(P + i)));
+            __m256i s = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(R.shift.data() + i)));
+            __m256i m = _mm256_loadu_si256((const __m256i*)(R.magic.data() + i));
+            __m256i x = _mm256_add_epi64(vlo, _mm256_sub_epi64(p, one));
+            __m256i q = mulhi_epu64(m, x);
+            q = _mm256_srlv_epi64(_mm256_add_epi64(_mm256_srli_epi64(_mm256_sub_epi64(x, q), 1), q), s);
+            // q * p with p < 2^32, made odd, then no lower than p^2
+            __m256i start = _mm256_add_epi64(_mm256_mul_epu32(q, p),
+                                             _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(q, 32), p), 32));
+            __m256i even = _mm256_cmpeq_epi64(_mm256_and_si256(q, one), _mm256_setzero_si256());
+            start = _mm256_add_epi64(start, _mm256_and_si256(p, even));
+            __m256i pp = _mm256_mul_epu32(p, p);
+            start = _mm256_blendv_epi8(start, pp, _mm256_cmpgt_epi64(pp, start));   // all < 2^63
+            _mm256_storeu_si256((__m256i*)(K + i), _mm256_srli_epi64(_mm256_sub_epi64(start, vlo), 1));
+        }
+    }
+    #endif
+    for (; i < count; ++i) {
+        u64 p = P[i], q = div_magic(lo + p - 1, R.magic[i], R.shift[i]);
+        u64 start = std::max(q * p + (q & 1 ? 0 : p), p * p);
+        K[i] = (start - lo) >> 1;
+    }
+}
+
+// Interleaved crossing
+// One prime's `while (idx < seg_size)` loop is a serial chain: every RMW
+// waits on idx += p, and consecutive stores to one word stall on forwarding.
+// Crossing LANES primes per iteration, each with its own index, gives the
+// core LANES independent chains to overlap. A group runs for the hit count
+// of its shortest chain (one division per prime, from the starts in K),
+// then each lane finishes alone and leaves its start in the following
+// segment in next (which may be K). With PF set, each lane prefetches
+// the word PF_HITS hits ahead of its current one. On an L1-resident segment
+// four lanes measure best in every tier; eight run out of registers, and the
+// prefetches only add work.
+constexpr u32 CROSS_LANES = 4;
+constexpr u32 PF_HITS = 8;
+
+template <u32 LANES, bool PF>
+void cross_primes(u64* seg, u64 seg_size, const u32* P, const u64* K, u64* next, size_t count) {
+    auto clear = [seg](u64 i) { seg[i >> 6] &= ~(1ULL << (i & 63)); };
+    size_t g = 0;
+    for (; g + LANES <= count; g += LANES) {
+        u64 k[LANES], p[LANES], steps = ~0ULL;
+        for (u32 j = 0; j < LANES; ++j) {
+            p[j] = P[g + j];
+            k[j] = K[g + j];
+            steps = std::min(steps, k[j] < seg_size ? (seg_size - k[j] + p[j] - 1) / p[j] : 0);
+        }
+        for (u64 t = 0; t < steps; ++t)
+            for (u32 j = 0; j < LANES; ++j) {
+                if (PF) prefetch_w(seg + (std::min(k[j] + PF_HITS * p[j], seg_size - 1) >> 6));
+                clear(k[j]);
+                k[j] += p[j];
+            }
+        for (u32 j = 0; j < LANES; ++j) {
+            for (; k[j] < seg_size; k[j] += p[j]) clear(k[j]);
+            next[g + j] = k[j] - seg_size;
+        }
+    }
+    for (; g < count; ++g) {
+        u64 k = K[g];
+        for (; k < seg_size; k += P[g]) clear(k);
+        next[g] = k - seg_size;
+    }
+}
+
+// Work-stealing deques
+// A shared `next_lo.fetch_add` hands out one segment per claim from one
+// cache line every core hits, and scatters each worker's segments, so each
+// one needs a reseed. Instead the segments are split into one contiguous
+// span per worker, cut into chunks of CHUNK_SEGS and pushed on the worker's
+// Chase-Lev deque (Le et al., PPoPP 2013), highest first. The owner pops at
+// the bottom, walks its span in order and carries K from segment to
+// segment. An idle worker steals a victim's top chunk, keeps the lower half
+// and pushes the upper half on its own deque, where it can be stolen again.
+// Every chunk exists at seeding, so the ring never grows.
+constexpr u32 CHUNK_SEGS = 16;
+
+struct Chunk { u32 begin, end; };           // segment indices [begin, end)
+
+class WorkDeque {
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    std::unique_ptr<std::atomic<u64>[]> ring;
+    int64_t mask = 0;
+
+    static u64 pack(Chunk c) { return (u64)c.end << 32 | c.begin; }
+    static Chunk unpack(u64 x) { return {(u32)x, (u32)(x >> 32)}; }
+
+public:
+    enum Result { Empty, Abort, Taken };
+
+    // Before any worker starts; capacity bounds the chunks held at once
+    void init(size_t capacity) {
+        size_t cap = 1;
+        while (cap < capacity) cap <<= 1;
+        ring.reset(new std::atomic<u64>[cap]);
+        mask = (int64_t)cap - 1;
+    }
+
+    // Owner only
+    void push(Chunk c) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        ring[b & mask].store(pack(c), std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only
+    bool pop(Chunk& c) {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        bool taken = t <= b;
+        if (taken) {
+            c = unpack(ring[b & mask].load(std::memory_order_relaxed));
+            if (t == b)                         // last chunk: race the thieves
+                taken = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed);
+        }
+        if (!taken || t == b) bottom.store(b + 1, std::memory_order_relaxed);
+        return taken;
+    }
+
+    // Any thread
+    Result steal(Chunk& c) {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return Empty;
+        c = unpack(ring[t & mask].load(std::memory_order_relaxed));
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)
+                   ? Taken : Abort;
+    }
+};
+
+struct RunStats {
+    u64 count;                              // odd primes in [3, n]
+    u64 reseeds;
+    u64 steals;
+};
+
+int main(int argc, char** argv) {
     using namespace std::chrono;
     
+    bool bench = false;
+    for (int i = 1; i < argc; ++i)
+        if (strcmp(argv[i], "--bench") == 0) bench = true;
+    
     constexpr u64 n = 1'000'000'000ULL;
     constexpr u32 S = 1 << 18;  // 256K odds per segment
     constexpr u32 SEG_WORDS = (S + 63) >> 6;
@@ -80,84 +360,118 @@ int main() {
     
     auto t0 = high_resolution_clock::now();
     
-    // Base primes
+    // Base primes; those below 64 go to the mask fill
     auto B = base_sieve((u32)std::sqrt((double)n) + 1);
+    const SmallPrimeMasks small;
+    size_t first_large = 1;
+    while (first_large < B.size() && B[first_large] < 64) ++first_large;
+    const u32* LP = B.data() + first_large;
+    const size_t num_large = B.size() - first_large;
+    const Reciprocals R(LP, num_large);
     
     auto t1 = high_resolution_clock::now();
     
-    // Parallel sieving
-    std::atomic<u64> next_lo{3};
-    std::vector<u64> thread_counts(num_threads, 0);
+    // Parallel sieving; segment s starts at 3 + s * 2S
+    const u32 num_segs = (u32)((n - 3) / (S << 1) + 1);
     
-    auto worker = [&](u32 tid) {
-        alignas(64) u64 seg[SEG_WORDS];
-        u64 local_cnt = 0;
+    auto sieve_parallel = [&](u32 threads, bool stealing) {
+        std::atomic<u64> next_lo{3};
+        std::vector<WorkDeque> deques(stealing ? threads : 0);
+        for (u32 w = 0; w < deques.size(); ++w) {
+            u32 begin = (u32)((u64)num_segs * w / threads), end = (u32)((u64)num_segs * (w + 1) / threads);
+            deques[w].init((end - begin) / CHUNK_SEGS + 2);
+            for (u32 b = end; end > begin; end = b) {      // highest chunk first
+                b = begin + (end - begin - 1) / CHUNK_SEGS * CHUNK_SEGS;
+                deques[w].push({b, end});
+            }
+        }
+        std::vector<RunStats> stats(threads);
         
-        while (true) {
-            u64 lo = next_lo.fetch_add(S << 1);
-            if (lo > n) break;
-            
-            u64 hi = std::min(lo + (S << 1) - 2, n);
-            u64 seg_size = ((hi - lo) >> 1) + 1;
-            u64 seg_words = (seg_size + 63) >> 6;
-            
-            // Fill with 1s (AVX2)
-            #if HAS_AVX2
-            avx2_fill_ones(seg, seg_words);
-            #else
-            std::fill(seg, seg + seg_words, ~0ULL);
-            #endif
-            
-            // Sieve
-            for (size_t i = 1; i < B.size(); ++i) {
-                u64 p = B[i];
-                u64 start;
-                if (p * p >= lo) {
-                    start = p * p;
-                } else {
-                    start = ((lo + p - 1) / p) * p;
-                    if (!(start & 1)) start += p;
+        auto steal_chunk = [&](u32 tid, Chunk& c) {
+            for (bool retry = true; retry; ) {
+                retry = false;
+                for (u32 i = 1; i < threads; ++i) {
+                    auto r = deques[(tid + i) % threads].steal(c);
+                    retry |= r == WorkDeque::Abort;
+                    if (r != WorkDeque::Taken) continue;
+                    if (c.end - c.begin > 1) {
+                        u32 mid = c.begin + (c.end - c.begin) / 2;
+                        deques[tid].push({mid, c.end});
+                        c.end = mid;
+                    }
+                    return true;
                 }
-                if (start > hi) continue;
+            }
+            return false;
+        };
+        
+        auto worker = [&](u32 tid) {
+            alignas(64) u64 seg[SEG_WORDS];
+            std::vector<u64> K(num_large);
+            RunStats local{0, 0, 0};
+            u64 carried_lo = 0;                 // segment K is valid for
+            
+            auto sieve_segment = [&](u64 lo) {
+                u64 hi = std::min(lo + (S << 1) - 2, n);
+                u64 seg_size = ((hi - lo) >> 1) + 1;
+                u64 seg_words = (seg_size + 63) >> 6;
                 
-                u64 idx = (start - lo) >> 1;
+                // Fill with the dense-prime masks already applied
+                small.fill(seg, seg_words, lo);
                 
-                // Unrolled for small primes
-                if (p < 64) {
-                    while (idx + 4 * p <= seg_size) {
-                        seg[idx >> 6] &= ~(1ULL << (idx & 63)); idx += p;
-                        seg[idx >> 6] &= ~(1ULL << (idx & 63)); idx += p;
-                        seg[idx >> 6] &= ~(1ULL << (idx & 63)); idx += p;
-                        seg[idx >> 6] &= ~(1ULL << (idx & 63)); idx += p;
-                    }
+                // Sieve the rest, four primes per pass
+                if (lo != carried_lo) {
+                    reseed<true>(K.data(), lo, LP, R, num_large);
+                    ++local.reseeds;
                 }
-                while (idx < seg_size) {
-                    seg[idx >> 6] &= ~(1ULL << (idx & 63));
-                    idx += p;
+                cross_primes<CROSS_LANES, false>(seg, seg_size, LP, K.data(), K.data(), num_large);
+                carried_lo = lo + (S << 1);
+                
+                // Count primes
+                for (size_t i = 0; i < seg_words; ++i)
+                    for (auto w = seg[i]; w; w &= w - 1)
+                        if (lo + (((i << 6) + ctz64(w)) << 1) <= n)
+                            ++local.count;
+            };
+            
+            if (stealing) {
+                Chunk c;
+                while (true) {
+                    if (!deques[tid].pop(c)) {
+                        if (!steal_chunk(tid, c)) break;
+                        ++local.steals;
+                    }
+                    for (u32 s = c.begin; s < c.end; ++s)
+                        sieve_segment(3 + (u64)s * (S << 1));
                 }
+            } else {
+                for (u64 lo; (lo = next_lo.fetch_add(S << 1)) <= n; )
+                    sieve_segment(lo);
             }
-            
-            // Count primes
-            for (size_t i = 0; i < seg_words; ++i)
-                for (auto w = seg[i]; w; w &= w - 1)
-                    if (lo + (((i << 6) + ctz64(w)) << 1) <= n)
-                        ++local_cnt;
-        }
+            stats[tid] = local;
+        };
         
-        thread_counts[tid] = local_cnt;
+        std::vector<std::thread> pool;
+        for (u32 i = 0; i < threads; ++i)
+            pool.emplace_back(worker, i);
+        for (auto& t : pool)
+            t.join();
+        
+        RunStats total{0, 0, 0};
+        for (const auto& st : stats) {
+            total.count += st.count;
+            total.reseeds += st.reseeds;
+            total.steals += st.steals;
+        }
+        return total;
     };
     
-    std::vector<std::thread> threads;
-    for (u32 i = 0; i < num_threads; ++i)
-        threads.emplace_back(worker, i);
-    for (auto& t : threads)
-        t.join();
+    RunStats run = sieve_parallel(num_threads, true);
     
     auto t2 = high_resolution_clock::now();
     
     // Sum counts
-    u64 cnt = 1;  // Include 2
-    for (auto c : thread_counts) cnt += c;
+    u64 cnt = 1 + run.count;  // Include 2
     
     // Get last 5 primes (single-threaded tail scan)
     u64 last5[5] = {};
@@ -169,27 +483,10 @@ int main() {
     u64 seg_size = ((hi - lo) >> 1) + 1;
     u64 seg_words = (seg_size + 63) >> 6;
     
-    #if HAS_AVX2
-    avx2_fill_ones(seg, seg_words);
-    #else
-    std::fill(seg, seg + seg_words, ~0ULL);
-    #endif
-    
-    for (size_t i = 1; i < B.size(); ++i) {
-        u64 p = B[i];
-        u64 start;
-        if (p * p >= lo) start = p * p;
-        else {
-            start = ((lo + p - 1) / p) * p;
-            if (!(start & 1)) start += p;
-        }
-        if (start > hi) continue;
-        u64 idx = (start - lo) >> 1;
-        while (idx < seg_size) {
-            seg[idx >> 6] &= ~(1ULL << (idx & 63));
-            idx += p;
-        }
-    }
+    std::vector<u64> K(num_large);
+    small.fill(seg, seg_words, lo);
+    reseed<true>(K.data(), lo, LP, R, num_large);
+    cross_primes<CROSS_LANES, false>(seg, seg_size, LP, K.data(), K.data(), num_large);
     
     for (size_t i = 0; i < seg_words; ++i)
         for (auto w = seg[i]; w; w &= w - 1) {
@@ -215,5 +512,115 @@ int main() {
     for (int i = 0; i < 5; ++i) std::cout << last5[(pos - 5 + i + 5) % 5] << ' ';
     std::cout << "\n\n";
     
-    std::cout << "Throughput: " << (n / (total_ms ? total_ms : 1)) / 1000 << " million/sec\n";
+    std::cout << "Throughput: " << (n / (total_ms ? total_ms : 1)) / 1000 << " million/sec\n\n";
+    
+    // Scheduling: shared counter against work stealing; the 4-thread runs
+    // exercise both where there are fewer cores. Each run is a full sieve,
+    // so this only runs with --bench.
+    bool sched_ok = true;
+    if (bench) {
+        std::cout << "Scheduling (" << num_segs << " segments, chunks of " << CHUNK_SEGS << "):\n";
+        for (auto [threads, stealing] : {std::pair<u32, bool>{num_threads, false}, {4, false},
+                                        {num_threads, true}, {4, true}}) {
+            auto k0 = high_resolution_clock::now();
+            RunStats st = sieve_parallel(threads, stealing);
+            auto ms = duration_cast<milliseconds>(high_resolution_clock::now() - k0).count();
+            sched_ok &= st.count + 1 == cnt;
+            std::cout << "  " << (stealing ? "work stealing" : "shared counter") << ", " << threads << " threads: "
+                      << ms << " ms, " << st.reseeds << " reseeds, " << st.steals << " steals\n";
+        }
+        std::cout << "Verify scheduling: " << (sched_ok ? "OK" : "MISMATCH") << "\n\n";
+    }
+    
+    // Microbenchmarks below run on one mid-range segment
+    u64 blo = 3 + (n / 2 / (S << 1)) * (S << 1);
+    alignas(64) u64 filled[SEG_WORDS];
+    small.fill(filled, SEG_WORDS, blo);
+    
+    // Crossing kernels per prime-size tier (--bench)
+    bool ok = true;
+    std::cout << std::fixed << std::setprecision(2);
+    if (bench) {
+        struct Kernel { const char* name; void (*fn)(u64*, u64, const u32*, const u64*, u64*, size_t); };
+        const Kernel kernels[] = {
+            {"serial", cross_primes<1, false>}, {"x4", cross_primes<4, false>},
+            {"x8", cross_primes<8, false>}, {"x4+pf", cross_primes<4, true>},
+        };
+        const u32 tiers[] = {64, 512, 4096, (u32)B.back() + 1};
+        std::vector<u64> carry(num_large);
+        alignas(64) u64 ref[SEG_WORDS];
+        std::cout << "Crossing tiers (ns per hit, segment at " << blo << "):\n";
+        for (u32 t = 0; t + 1 < 4; ++t) {
+            size_t a = first_large, b;
+            while (B[a] < tiers[t]) ++a;
+            for (b = a; b < B.size() && B[b] < tiers[t + 1]; ++b) {}
+            u64 hits = 0;
+            for (size_t i = a; i < b; ++i) {
+                K[i - first_large] = first_index(B[i], blo);
+                if (K[i - first_large] < S) hits += (S - K[i - first_large] + B[i] - 1) / B[i];
+            }
+            const u64* KT = K.data() + (a - first_large);
+            std::copy(filled, filled + SEG_WORDS, ref);
+            kernels[0].fn(ref, S, B.data() + a, KT, carry.data(), b - a);
+            std::cout << "  p in [" << tiers[t] << ", " << tiers[t + 1] << "): ";
+            double serial_ns = 0;
+            for (const auto& kr : kernels) {
+                constexpr int REPS = 200;
+                double best = 1e30;
+                for (int r = 0; r < REPS; ++r) {
+                    std::copy(filled, filled + SEG_WORDS, seg);
+                    auto k0 = high_resolution_clock::now();
+                    kr.fn(seg, S, B.data() + a, KT, carry.data(), b - a);
+                    best = std::min(best, duration<double, std::nano>(high_resolution_clock::now() - k0).count());
+                }
+                ok &= std::equal(seg, seg + SEG_WORDS, ref);
+                double ns = best / hits;
+                if (&kr == kernels) serial_ns = ns;
+                std::cout << kr.name << " " << ns << " (" << serial_ns / ns << "x)  ";
+            }
+            std::cout << "\n";
+        }
+        std::cout << "Verify kernels: " << (ok ? "OK" : "MISMATCH") << "\n\n";
+    }
+    
+    // Reseeding one segment: hardware divide vs scalar and AVX2 reciprocals.
+    // At 1e13 the base primes run to sqrt(1e13), ~220k of them. (--bench)
+    bool reseed_ok = true;
+    if (bench) {
+        std::cout << "Reseed (ns per prime):\n";
+        for (u64 rlo : {blo, (u64)10'000'000'000'001ULL}) {
+            u64 rhi = rlo + (S << 1) - 2;
+            auto RB = base_sieve((u32)std::sqrt((double)rhi) + 1);
+            size_t rf = 1;
+            while (RB[rf] < 64) ++rf;
+            const u32* RP = RB.data() + rf;
+            const size_t rn = RB.size() - rf;
+            const Reciprocals RR(RP, rn);
+            std::vector<u64> want(rn), got(rn), next(rn);
+            auto time_ns = [&](auto&& fn) {
+                double best = 1e30;
+                for (int r = 0; r < 20; ++r) {
+                    auto k0 = high_resolution_clock::now();
+                    fn();
+                    best = std::min(best, duration<double, std::nano>(high_resolution_clock::now() - k0).count());
+                }
+                return best / rn;
+            };
+            double div_ns = time_ns([&] { for (size_t i = 0; i < rn; ++i) want[i] = first_index(RP[i], rlo); });
+            double mag_ns = time_ns([&] { reseed<false>(got.data(), rlo, RP, RR, rn); });
+            reseed_ok &= want == got;
+            double vec_ns = time_ns([&] { reseed<true>(got.data(), rlo, RP, RR, rn); });
+            reseed_ok &= want == got;
+            double seg_ns = time_ns([&] {
+                std::copy(filled, filled + SEG_WORDS, seg);
+                cross_primes<CROSS_LANES, false>(seg, S, RP, got.data(), next.data(), rn);
+            });
+            std::cout << "  lo = " << rlo << ", " << rn << " primes: divide " << div_ns
+                      << ", reciprocal " << mag_ns << " (" << div_ns / mag_ns << "x), "
+                      << (HAS_AVX2 ? "AVX2 " : "scalar ") << vec_ns << " (" << div_ns / vec_ns << "x); "
+                      << "setup " << 100 * vec_ns / seg_ns << "% of crossing\n";
+        }
+        std::cout << "Verify reseed: " << (reseed_ok ? "OK" : "MISMATCH") << "\n";
+    }
+    return ok && reseed_ok && sched_ok ? 0 : 1;
 }
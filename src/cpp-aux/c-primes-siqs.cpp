@@ -0,0 +1,992 @@
+// c-primes-siqs.cpp
+// Self-initialising quadratic sieve (SIQS) for 30-70 digit composites
+// Compile: g++ -O3 -march=native -pthread -std=c++17 c-primes-siqs.cpp -o c-primes-siqs
+// Usage:   c-primes-siqs [N ...]   (decimal; defaults to a 30/40/50/60 digit batch)
+//
+// Factor base from base_sieve, 32KB cache-blocked log sieve over [-M, M) per
+// polynomial with large primes bucketed by block, single large prime
+// variation, threaded relation collection, singleton filtering + dense
+// Gaussian elimination over GF(2). Bignum arithmetic is in this file.
+//
+// Inputs above 70 digits are rejected. The parameter table stops at the
+// largest size that was run end to end (70 digits, ~77 s on one core). Past
+// that, the dense O(n^3) elimination (~200 MB at 90 digits) would need block
+// Lanczos or a structured elimination that really shrinks the matrix.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define HAS_AVX2 1
+#else
+#define HAS_AVX2 0
+#endif
+
+using u64 = uint64_t;
+using u32 = uint32_t;
+using u8 = uint8_t;
+using i64 = int64_t;
+using u128 = unsigned __int128;
+using i128 = __int128;
+
+inline int ctz64(u64 x) { return __builtin_ctzll(x); }
+
+// ============================================================================
+// Bignum (unsigned, little-endian 64-bit limbs, no leading zero limbs)
+// ============================================================================
+struct Big {
+    std::vector<u64> d;
+
+    Big() = default;
+    Big(u64 v) { if (v) d.push_back(v); }
+
+    bool zero() const { return d.empty(); }
+    void trim() { while (!d.empty() && !d.back()) d.pop_back(); }
+    u32 bits() const { return d.empty() ? 0 : 64 * (u32)(d.size() - 1) + 64 - __builtin_clzll(d.back()); }
+    double log2() const {
+        if (d.empty()) return -1;
+        u32 b = bits();
+        if (b <= 64) return std::log2((double)d[0]);
+        u32 sh = b - 64;
+        u64 top = d[sh / 64] >> (sh % 64);
+        if (sh % 64) top |= d[sh / 64 + 1] << (64 - sh % 64);
+        return std::log2((double)top) + sh;
+    }
+};
+
+int cmp(const Big& a, const Big& b) {
+    if (a.d.size() != b.d.size()) return a.d.size() < b.d.size() ? -1 : 1;
+    for (size_t i = a.d.size(); i-- > 0; )
+        if (a.d[i] != b.d[i]) return a.d[i] < b.d[i] ? -1 : 1;
+    return 0;
+}
+
+Big add(const Big& a, const Big& b) {
+    const Big& x = a.d.size() >= b.d.size() ? a : b;
+    const Big& y = a.d.size() >= b.d.size() ? b : a;
+    Big r;
+    r.d.resize(x.d.size() + 1);
+    u64 c = 0;
+    for (size_t i = 0; i < x.d.size(); ++i) {
+        u128 t = (u128)x.d[i] + (i < y.d.size() ? y.d[i] : 0) + c;
+        r.d[i] = (u64)t;
+        c = (u64)(t >> 64);
+    }
+    r.d.back() = c;
+    r.trim();
+    return r;
+}
+
+// a - b, requires a >= b
+Big sub(const Big& a, const Big& b) {
+    Big r;
+    r.d.resize(a.d.size());
+    u64 br = 0;
+    for (size_t i = 0; i < a.d.size(); ++i) {
+        u64 y = i < b.d.size() ? b.d[i] : 0;
+        u128 t = (u128)a.d[i] - y - br;
+        r.d[i] = (u64)t;
+        br = (u64)(t >> 64) & 1;
+    }
+    r.trim();
+    return r;
+}
+
+Big mul(const Big& a, const Big& b) {
+    if (a.zero() || b.zero()) return Big();
+    Big r;
+    r.d.assign(a.d.size() + b.d.size(), 0);
+    for (size_t i = 0; i < a.d.size(); ++i) {
+        u64 c = 0;
+        for (size_t j = 0; j < b.d.size(); ++j) {
+            u128 t = (u128)a.d[i] * b.d[j] + r.d[i + j] + c;
+            r.d[i + j] = (u64)t;
+            c = (u64)(t >> 64);
+        }
+        r.d[i + b.d.size()] = c;
+    }
+    r.trim();
+    return r;
+}
+
+Big mul_small(const Big& a, u64 m) {
+    Big r;
+    r.d.resize(a.d.size() + 1);
+    u64 c = 0;
+    for (size_t i = 0; i < a.d.size(); ++i) {
+        u128 t = (u128)a.d[i] * m + c;
+        r.d[i] = (u64)t;
+        c = (u64)(t >> 64);
+    }
+    r.d.back() = c;
+    r.trim();
+    return r;
+}
+
+// a mod m for m < 2^32, in 32-bit halves so no 128-bit division is emitted
+u32 mod_small(const Big& a, u32 m) {
+    u64 r = 0;
+    for (size_t i = a.d.size(); i-- > 0; ) {
+        r = ((r << 32) | (a.d[i] >> 32)) % m;
+        r = ((r << 32) | (a.d[i] & 0xFFFFFFFFu)) % m;
+    }
+    return (u32)r;
+}
+
+// a / m for m < 2^32
+Big div_small(const Big& a, u32 m) {
+    Big q;
+    q.d.resize(a.d.size());
+    u64 r = 0;
+    for (size_t i = a.d.size(); i-- > 0; ) {
+        u64 hi = (r << 32) | (a.d[i] >> 32);
+        u64 qh = hi / m;
+        r = hi % m;
+        u64 lo = (r << 32) | (a.d[i] & 0xFFFFFFFFu);
+        u64 ql = lo / m;
+        r = lo % m;
+        q.d[i] = (qh << 32) | ql;
+    }
+    q.trim();
+    return q;
+}
+
+Big shl(const Big& a, u32 s) {
+    if (a.zero()) return a;
+    Big r;
+    r.d.assign(a.d.size() + s / 64 + 1, 0);
+    u32 w = s / 64, b = s % 64;
+    for (size_t i = 0; i < a.d.size(); ++i) {
+        r.d[i + w] |= a.d[i] << b;
+        if (b) r.d[i + w + 1] |= a.d[i] >> (64 - b);
+    }
+    r.trim();
+    return r;
+}
+
+Big shr(const Big& a, u32 s) {
+    u32 w = s / 64, b = s % 64;
+    if (w >= a.d.size()) return Big();
+    Big r;
+    r.d.assign(a.d.size() - w, 0);
+    for (size_t i = 0; i < r.d.size(); ++i) {
+        r.d[i] = a.d[i + w] >> b;
+        if (b && i + w + 1 < a.d.size()) r.d[i] |= a.d[i + w + 1] << (64 - b);
+    }
+    r.trim();
+    return r;
+}
+
+// Knuth algorithm D; q or r may be null
+void divmod(const Big& a, const Big& b, Big* q, Big* r) {
+    if (cmp(a, b) < 0) {
+        if (q) *q = Big();
+        if (r) *r = a;
+        return;
+    }
+    size_t n = b.d.size(), m = a.d.size() - n;
+    if (n == 1) {
+        Big qq;
+        qq.d.resize(a.d.size());
+        u128 rem = 0;
+        for (size_t i = a.d.size(); i-- > 0; ) {
+            u128 cur = (rem << 64) | a.d[i];
+            qq.d[i] = (u64)(cur / b.d[0]);
+            rem = cur % b.d[0];
+        }
+        qq.trim();
+        if (q) *q = qq;
+        if (r) *r = Big((u64)rem);
+        return;
+    }
+    u32 s = __builtin_clzll(b.d.back());
+    Big vb = shl(b, s), ub = shl(a, s);
+    std::vector<u64>& v = vb.d;
+    std::vector<u64> u = ub.d;
+    u.resize(a.d.size() + 1, 0);
+    Big qq;
+    qq.d.assign(m + 1, 0);
+    for (size_t j = m + 1; j-- > 0; ) {
+        u128 num = ((u128)u[j + n] << 64) | u[j + n - 1];
+        u128 qhat = num / v[n - 1], rhat = num % v[n - 1];
+        while ((qhat >> 64) || qhat * v[n - 2] > ((rhat << 64) | u[j + n - 2])) {
+            --qhat;
+            rhat += v[n - 1];
+            if (rhat >> 64) break;
+        }
+        i128 k = 0, t;
+        for (size_t i = 0; i < n; ++i) {
+            u128 p = qhat * v[i];
+            t = (i128)u[i + j] - k - (i128)(u64)p;
+            u[i + j] = (u64)t;
+            k = (i128)(u64)(p >> 64) - (t >> 64);
+        }
+        t = (i128)u[j + n] - k;
+        u[j + n] = (u64)t;
+        if (t < 0) {
+            --qhat;
+            u64 c = 0;
+            for (size_t i = 0; i < n; ++i) {
+                u128 s2 = (u128)u[i + j] + v[i] + c;
+                u[i + j] = (u64)s2;
+                c = (u64)(s2 >> 64);
+            }
+            u[j + n] += c;
+        }
+        qq.d[j] = (u64)qhat;
+    }
+    qq.trim();
+    if (q) *q = qq;
+    if (r) {
+        Big rr;
+        rr.d.assign(u.begin(), u.begin() + n);
+        rr.trim();
+        *r = shr(rr, s);
+    }
+}
+
+Big mod(const Big& a, const Big& m) { Big r; divmod(a, m, nullptr, &r); return r; }
+Big mulmod(const Big& a, const Big& b, const Big& m) { return mod(mul(a, b), m); }
+
+Big powmod(Big a, const Big& e, const Big& m) {
+    Big r(1);
+    a = mod(a, m);
+    for (u32 i = 0, nb = e.bits(); i < nb; ++i) {
+        if (e.d[i / 64] >> (i % 64) & 1) r = mulmod(r, a, m);
+        a = mulmod(a, a, m);
+    }
+    return r;
+}
+
+Big gcd(Big a, Big b) {
+    while (!b.zero()) {
+        Big r = mod(a, b);
+        a = std::move(b);
+        b = std::move(r);
+    }
+    return a;
+}
+
+Big isqrt(const Big& a) {
+    if (a.zero()) return a;
+    Big x = shl(Big(1), (a.bits() + 1) / 2 + 1);
+    while (true) {
+        Big q;
+        divmod(a, x, &q, nullptr);
+        Big y = shr(add(x, q), 1);
+        if (cmp(y, x) >= 0) return x;
+        x = std::move(y);
+    }
+}
+
+Big from_dec(const std::string& s) {
+    Big r;
+    for (char c : s) {
+        if (c < '0' || c > '9') continue;
+        r = add(mul_small(r, 10), Big((u64)(c - '0')));
+    }
+    return r;
+}
+
+std::string to_dec(Big a) {
+    if (a.zero()) return "0";
+    std::string s;
+    while (!a.zero()) {
+        u32 r = mod_small(a, 1000000000u);
+        a = div_small(a, 1000000000u);
+        for (int i = 0; i < 9; ++i, r /= 10) s += char('0' + r % 10);
+    }
+    while (s.size() > 1 && s.back() == '0') s.pop_back();
+    return {s.rbegin(), s.rend()};
+}
+
+// Miller-Rabin on Big, used only to label the factors found
+bool is_probable_prime(const Big& n) {
+    if (n.bits() < 2) return false;
+    for (u32 p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37})
+        if (mod_small(n, p) == 0) return cmp(n, Big(p)) == 0;
+    Big nm1 = sub(n, Big(1)), d = nm1;
+    u32 s = 0;
+    while (!(d.d[0] & 1)) { d = shr(d, 1); ++s; }
+    for (u64 a : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37}) {
+        Big x = powmod(Big(a), d, n);
+        if (cmp(x, Big(1)) == 0 || cmp(x, nm1) == 0) continue;
+        bool composite = true;
+        for (u32 r = 1; r < s && composite; ++r)
+            composite = cmp(x = mulmod(x, x, n), nm1) != 0;
+        if (composite) return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Base sieve and small modular helpers
+// ============================================================================
+std::vector<u32> base_sieve(u32 n) {
+    u32 h = n / 2 + 1;
+    std::vector<u64> b((h + 63) >> 6, ~0ULL);
+    b[0] ^= 1;
+    for (u32 i = 1, L = (u32)std::sqrt(n) / 2; i <= L; ++i)
+        if (b[i >> 6] >> (i & 63) & 1)
+            for (u32 j = 2*i*(i+1), s = 2*i+1; j < h; j += s)
+                b[j >> 6] &= ~(1ULL << (j & 63));
+    std::vector<u32> P{2};
+    for (u32 i = 0; i < b.size(); ++i)
+        for (auto w = b[i]; w; w &= w - 1) {
+            u32 v = ((i << 6) + ctz64(w)) * 2 + 1;
+            if (v > 1 && v <= n) P.push_back(v);
+        }
+    return P;
+}
+
+u64 powmod_u(u64 a, u64 e, u64 p) {
+    u64 r = 1;
+    for (a %= p; e; e >>= 1, a = a * a % p)
+        if (e & 1) r = r * a % p;
+    return r;
+}
+
+u32 inv_mod(u32 a, u32 p) { return (u32)powmod_u(a, p - 2, p); }
+
+// Square root of a quadratic residue a mod odd prime p (Tonelli-Shanks)
+u64 sqrt_mod(u64 a, u64 p) {
+    if (a == 0) return 0;
+    if ((p & 3) == 3) return powmod_u(a, (p + 1) >> 2, p);
+    u64 q = p - 1;
+    int s = ctz64(q);
+    q >>= s;
+    u64 z = 2;
+    while (powmod_u(z, (p - 1) >> 1, p) != p - 1) ++z;
+    u64 c = powmod_u(z, q, p), x = powmod_u(a, (q + 1) >> 1, p), t = powmod_u(a, q, p);
+    for (int m = s; t != 1; ) {
+        int i = 0;
+        for (u64 tt = t; tt != 1; tt = tt * tt % p) ++i;
+        u64 b = c;
+        for (int j = 0; j < m - i - 1; ++j) b = b * b % p;
+        x = x * b % p;
+        c = b * b % p;
+        t = t * c % p;
+        m = i;
+    }
+    return x;
+}
+
+// splitmix64, for picking the primes of each A
+struct Rng {
+    u64 s;
+    u64 next() { u64 z = (s += 0x9E3779B97F4A7C15ULL); z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                 z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL; return z ^ (z >> 31); }
+};
+
+// ============================================================================
+// Parameters and factor base
+// ============================================================================
+constexpr u32 BLOCK = 1 << 15;          // 32KB sieve block
+constexpr u32 EXTRA_RELS = 96;          // relations beyond the factor base size
+constexpr double T_SLACK = 9;           // bits below the nominal threshold (tuned at 50-70 digits)
+constexpr u32 FB_MAX = 1 << 17;         // bucket entries pack the index in 17 bits
+
+struct Params {
+    u32 digits, fb_size, blocks, lp_mult;   // blocks per side of [-M, M)
+};
+
+// Interpolated between rows by digit count; every row has been run
+constexpr Params PARAM_TABLE[] = {
+    {30,   200, 1,  30}, {40,   600, 1,  40}, {50,  1500, 2,  50},
+    {60,  3000, 3,  60}, {70,  6500, 4,  80},
+};
+constexpr u32 MAX_DIGITS = 70;
+
+Params params_for(u32 digits) {
+    constexpr size_t K = sizeof(PARAM_TABLE) / sizeof(PARAM_TABLE[0]);
+    if (digits <= PARAM_TABLE[0].digits) return PARAM_TABLE[0];
+    for (size_t i = 1; i < K; ++i)
+        if (digits <= PARAM_TABLE[i].digits) {
+            const Params &a = PARAM_TABLE[i - 1], &b = PARAM_TABLE[i];
+            double f = double(digits - a.digits) / (b.digits - a.digits);
+            return {digits, (u32)(a.fb_size + f * (b.fb_size - a.fb_size)),
+                    f < 0.5 ? a.blocks : b.blocks, (u32)(a.lp_mult + f * (b.lp_mult - a.lp_mult))};
+        }
+    return PARAM_TABLE[K - 1];
+}
+
+// Knuth-Schroeppel: pick k so small primes are likely to divide Q(x)
+u32 choose_multiplier(const Big& N, const std::vector<u32>& P) {
+    static const u32 ks[] = {1, 2, 3, 5, 6, 7, 10, 11, 13, 14, 15, 17, 19, 21, 22, 23, 26, 29,
+                             30, 31, 33, 34, 35, 37, 38, 39, 41, 42, 43, 46, 47, 51, 53, 55,
+                             57, 58, 59, 61, 62, 65, 66, 67, 69, 70, 71, 73};
+    u32 best = 1;
+    double best_score = -1e30;
+    for (u32 k : ks) {
+        Big kN = mul_small(N, k);
+        double score = -0.5 * std::log((double)k);
+        u32 m8 = mod_small(kN, 8);
+        if (m8 == 1) score += 2 * std::log(2.0);
+        else if (m8 == 5) score += std::log(2.0);
+        else if (m8 == 3 || m8 == 7) score += 0.5 * std::log(2.0);
+        for (size_t i = 1; i < P.size() && P[i] < 1000; ++i) {
+            u32 p = P[i];
+            double lp = std::log((double)p);
+            if (k % p == 0) score += lp / p;
+            else if (powmod_u(mod_small(kN, p), (p - 1) / 2, p) == 1) score += 2 * lp / (p - 1);
+        }
+        if (score > best_score) { best_score = score; best = k; }
+    }
+    return best;
+}
+
+// ============================================================================
+// Relations
+// ============================================================================
+// Y^2 = Q (mod N) with Q = product of fb[f[i]] (index 0 stands for -1) times
+// the square of every entry of lp. Combined partials carry their shared
+// large prime in lp.
+struct Relation {
+    Big Y;
+    std::vector<u32> f;
+    std::vector<u64> lp;
+};
+
+struct RelationStore {
+    std::mutex mtx;
+    std::vector<Relation> full;
+    std::unordered_map<u64, Relation> partial;
+    u64 n_full = 0, n_partial = 0, n_combined = 0;
+
+    // Returns the number of usable relations after adding
+    u64 add(Relation&& r, u64 large, const Big& N) {
+        std::lock_guard<std::mutex> lk(mtx);
+        if (large == 1) {
+            ++n_full;
+            full.push_back(std::move(r));
+        } else {
+            ++n_partial;
+            auto it = partial.find(large);
+            if (it == partial.end()) {
+                partial.emplace(large, std::move(r));
+            } else {
+                Relation c;
+                c.Y = mulmod(it->second.Y, r.Y, N);
+                c.f = it->second.f;
+                c.f.insert(c.f.end(), r.f.begin(), r.f.end());
+                c.lp = {large};
+                ++n_combined;
+                full.push_back(std::move(c));
+            }
+        }
+        return full.size();
+    }
+};
+
+// ============================================================================
+// SIQS
+// ============================================================================
+struct Siqs {
+    Big N, kN;
+    u32 k;
+    Params prm;
+    std::vector<u32> fb;        // fb[0] = 0 stands for -1
+    std::vector<u32> tsqrt;     // sqrt(kN) mod p
+    std::vector<u8> logp;
+    u32 M, nblocks;             // x in [-M, M), 2M / BLOCK blocks
+    u32 small_cut, large_cut;   // sieve fb[small_cut..large_cut) per block, rest bucketed
+    u32 s_afact;                // primes per A
+    u32 pool_lo, pool_hi;       // fb index range the A primes come from
+    double a_target_log2;
+    u64 lp_bound;
+    u8 threshold;
+    Big factor_found;           // set when the factor base hits a factor of N
+
+    struct Stats {
+        u64 polys = 0, a_count = 0, candidates = 0;
+    };
+
+    explicit Siqs(const Big& N_) : N(N_) {
+        prm = params_for((u32)to_dec(N).size());
+        auto P = base_sieve(std::max<u32>(prm.fb_size * 40, 2000));
+        k = choose_multiplier(N, P);
+        kN = mul_small(N, k);
+
+        fb = {0, 2};
+        tsqrt = {0, mod_small(kN, 2)};
+        for (size_t i = 1; i < P.size() && fb.size() < prm.fb_size && fb.size() < FB_MAX; ++i) {
+            u32 p = P[i];
+            u32 r = mod_small(kN, p);
+            if (r == 0) {
+                if (k % p) { factor_found = Big(p); return; }
+                fb.push_back(p); tsqrt.push_back(0);
+            } else if (powmod_u(r, (p - 1) / 2, p) == 1) {
+                fb.push_back(p); tsqrt.push_back((u32)sqrt_mod(r, p));
+            }
+        }
+        logp.resize(fb.size());
+        for (size_t i = 1; i < fb.size(); ++i) logp[i] = (u8)std::lround(std::log2((double)fb[i]));
+
+        M = prm.blocks * BLOCK;
+        nblocks = 2 * prm.blocks;
+        small_cut = 1;
+        while (small_cut < fb.size() && fb[small_cut] < 30) ++small_cut;
+        large_cut = small_cut;
+        while (large_cut < fb.size() && fb[large_cut] < BLOCK) ++large_cut;
+        lp_bound = (u64)fb.back() * prm.lp_mult;
+
+        // A ~ sqrt(2kN) / M, built from s primes near 2000 when the factor base reaches
+        a_target_log2 = 0.5 * (kN.log2() + 1) - std::log2((double)M);
+        double q_goal = std::min(2000.0, fb.back() / 4.0);
+        s_afact = std::max<u32>(2, (u32)std::lround(a_target_log2 / std::log2(q_goal)));
+        double q_avg = std::exp2(a_target_log2 / s_afact);
+        pool_lo = small_cut;
+        while (pool_lo < fb.size() && fb[pool_lo] < q_avg / 2) ++pool_lo;
+        pool_hi = pool_lo;
+        while (pool_hi < fb.size() && fb[pool_hi] < q_avg * 2) ++pool_hi;
+
+        // |g(x)| peaks near M sqrt(kN / 2); let through one large prime, the
+        // expected contribution of the unsieved primes below 30, and T_SLACK
+        // for rounded logs and the many x where |g| is well below its peak
+        double small_bits = 0;
+        for (u32 i = 1; i < small_cut; ++i)
+            if (tsqrt[i]) small_bits += 2 * std::log2((double)fb[i]) / (fb[i] - 1);
+        double t = std::log2((double)M) + 0.5 * (kN.log2() - 1) - std::log2((double)lp_bound)
+                 - small_bits - T_SLACK;
+        threshold = (u8)std::max(0.0, std::min(250.0, t));
+    }
+
+    // One worker: claims A indices from `next_a`, sieves all 2^(s-1) B
+    // polynomials of each, and hands relations to the store until `done`.
+    void worker(std::atomic<u64>& next_a, std::atomic<bool>& done, RelationStore& store,
+                std::unordered_set<u64>& seen_a, std::mutex& seen_mtx, u64 target, Stats& st) const {
+        const size_t F = fb.size();
+        const u32 s = s_afact;
+        std::vector<u32> ainv(F), r1(F), r2(F), cur1(F), cur2(F);
+        std::vector<std::vector<u32>> Bainv(s, std::vector<u32>(F));
+        std::vector<u8> isA(F);
+        std::vector<std::vector<u32>> bucket(nblocks);
+        alignas(64) static thread_local u8 sieve[BLOCK];
+        std::vector<u32> aidx(s);
+        std::vector<Big> Bl(s);
+
+        while (!done.load(std::memory_order_relaxed)) {
+            // --- choose A = q_0 ... q_{s-1} ---
+            u64 a_no = next_a.fetch_add(1);
+            Rng rng{a_no * 0x2545F4914F6CDD1DULL + 7};
+            Big A;
+            bool ok = false;
+            for (int attempt = 0; attempt < 100 && !ok; ++attempt) {
+                A = Big(1);
+                double lg = 0;
+                u32 span = pool_hi - pool_lo;
+                for (u32 j = 0; j + 1 < s; ++j) {
+                    u32 i;
+                    do i = pool_lo + (u32)(rng.next() % span);
+                    while (std::find(aidx.begin(), aidx.begin() + j, i) != aidx.begin() + j);
+                    aidx[j] = i;
+                    lg += std::log2((double)fb[i]);
+                }
+                // last prime brings A closest to the target
+                double want = std::exp2(a_target_log2 - lg);
+                u32 best = 0;
+                double err = 1e300;
+                for (u32 i = small_cut; i < F; ++i) {
+                    if (std::find(aidx.begin(), aidx.begin() + s - 1, i) != aidx.begin() + s - 1) continue;
+                    double e = std::fabs(std::log2(fb[i] / want));
+                    if (e < err) { err = e; best = i; }
+                    if (fb[i] > want * 2) break;
+                }
+                if (!best) continue;
+                aidx[s - 1] = best;
+                std::vector<u32> key(aidx);
+                std::sort(key.begin(), key.end());
+                u64 h = 1469598103934665603ULL;
+                for (u32 v : key) h = (h ^ v) * 1099511628211ULL;
+                std::lock_guard<std::mutex> lk(seen_mtx);
+                ok = seen_a.insert(h).second;
+            }
+            if (!ok) continue;
+            for (u32 j = 0; j < s; ++j) A = mul_small(A, fb[aidx[j]]);
+            ++st.a_count;
+
+            // --- B_l with B_l^2 = kN (mod q_l), B_l = 0 (mod q_m), m != l ---
+            SBig B;
+            for (u32 l = 0; l < s; ++l) {
+                u32 q = fb[aidx[l]];
+                Big Aq = div_small(A, q);
+                u64 g = (u64)tsqrt[aidx[l]] * inv_mod(mod_small(Aq, q), q) % q;
+                if (g > q / 2) g = q - g;
+                Bl[l] = mul_small(Aq, g);
+                B = B.add(SBig{Bl[l], false});
+            }
+
+            std::fill(isA.begin(), isA.end(), 0);
+            for (u32 j = 0; j < s; ++j) isA[aidx[j]] = 1;
+            for (size_t i = 1; i < F; ++i) {
+                u32 p = fb[i];
+                if (isA[i] || p == 2) { ainv[i] = 0; continue; }
+                u32 am = mod_small(A, p);
+                ainv[i] = inv_mod(am, p);
+                u32 bm = mod_small(B.m, p);
+                if (B.neg) bm = (p - bm) % p;
+                u32 Mm = M % p;
+                r1[i] = (u32)(((u64)ainv[i] * ((tsqrt[i] + p - bm) % p) + Mm) % p);
+                r2[i] = (u32)(((u64)ainv[i] * ((2 * (u64)p - tsqrt[i] - bm) % p) + Mm) % p);
+                for (u32 l = 0; l < s; ++l)
+                    Bainv[l][i] = (u32)(2 * (u64)mod_small(Bl[l], p) * ainv[i] % p);
+            }
+
+            // --- sieve each B polynomial, Gray code order ---
+            u64 npoly = 1ULL << (s - 1);
+            for (u64 pi = 0; pi < npoly && !done.load(std::memory_order_relaxed); ++pi) {
+                if (pi) {
+                    u32 l = ctz64(pi) + 1;
+                    bool neg = ((pi ^ (pi >> 1)) >> (l - 1)) & 1;
+                    B = B.add(SBig{shl(Bl[l], 1), neg});
+                    const u32* ba = Bainv[l].data();
+                    for (size_t i = 1; i < F; ++i) {
+                        if (!ainv[i]) continue;
+                        u32 p = fb[i];
+                        if (neg) {    // B down by 2B_l, roots up by Bainv
+                            r1[i] += ba[i]; if (r1[i] >= p) r1[i] -= p;
+                            r2[i] += ba[i]; if (r2[i] >= p) r2[i] -= p;
+                        } else {
+                            r1[i] += p - ba[i]; if (r1[i] >= p) r1[i] -= p;
+                            r2[i] += p - ba[i]; if (r2[i] >= p) r2[i] -= p;
+                        }
+                    }
+                }
+                ++st.polys;
+                sieve_poly(A, B, aidx, isA, ainv, r1, r2, cur1, cur2, bucket, sieve, store, target, done, st);
+            }
+        }
+    }
+
+    // Signed bignum for B and Ax + B
+    struct SBig {
+        Big m;
+        bool neg = false;
+        SBig add(const SBig& o) const {
+            if (neg == o.neg) return {::add(m, o.m), neg};
+            int c = cmp(m, o.m);
+            if (c == 0) return {};
+            return c > 0 ? SBig{sub(m, o.m), neg} : SBig{sub(o.m, m), o.neg};
+        }
+    };
+
+    void sieve_poly(const Big& A, const SBig& B, const std::vector<u32>& aidx, const std::vector<u8>& isA,
+                    const std::vector<u32>& ainv, const std::vector<u32>& r1, const std::vector<u32>& r2,
+                    std::vector<u32>& cur1, std::vector<u32>& cur2, std::vector<std::vector<u32>>& bucket,
+                    u8* sieve, RelationStore& store, u64 target, std::atomic<bool>& done, Stats& st) const {
+        const size_t F = fb.size();
+        const u32 len = 2 * M;
+
+        // Large primes: every hit in [0, 2M) goes to its block's bucket
+        for (auto& b : bucket) b.clear();
+        for (size_t i = large_cut; i < F; ++i) {
+            if (!ainv[i]) continue;
+            u32 p = fb[i];
+            for (u32 pos = r1[i]; pos < len; pos += p) bucket[pos / BLOCK].push_back((pos % BLOCK) | (u32)(i << 15));
+            if (r2[i] != r1[i])
+                for (u32 pos = r2[i]; pos < len; pos += p) bucket[pos / BLOCK].push_back((pos % BLOCK) | (u32)(i << 15));
+        }
+        for (size_t i = small_cut; i < large_cut; ++i) { cur1[i] = r1[i]; cur2[i] = r2[i]; }
+
+        for (u32 blk = 0; blk < nblocks; ++blk) {
+            std::fill(sieve, sieve + BLOCK, 0);
+            for (size_t i = small_cut; i < large_cut; ++i) {
+                if (!ainv[i]) continue;
+                u32 p = fb[i];
+                u8 lg = logp[i];
+                u32 a = cur1[i], b = cur2[i];
+                if (a == b) {
+                    for (; a < BLOCK; a += p) sieve[a] += lg;
+                    cur1[i] = cur2[i] = a - BLOCK;
+                    continue;
+                }
+                if (a > b) std::swap(a, b);
+                for (; b < BLOCK; a += p, b += p) { sieve[a] += lg; sieve[b] += lg; }
+                if (a < BLOCK) { sieve[a] += lg; a += p; }
+                cur1[i] = a - BLOCK;
+                cur2[i] = b - BLOCK;
+            }
+            for (u32 e : bucket[blk]) sieve[e & 0x7FFF] += logp[e >> 15];
+
+            // scan
+            u32 i = 0;
+            #if HAS_AVX2
+            __m256i vt = _mm256_set1_epi8((char)threshold);
+            for (; i < BLOCK; i += 32) {
+                __m256i v = _mm256_load_si256((const __m256i*)(sieve + i));
+                u32 m = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(v, vt), v));
+                for (; m; m &= m - 1) {
+                    ++st.candidates;
+                    check(blk, i + ctz64(m), A, B, aidx, isA, ainv, r1, r2, bucket[blk], store, target, done);
+                }
+            }
+            #else
+            for (; i < BLOCK; ++i)
+                if (sieve[i] >= threshold) {
+                    ++st.candidates;
+                    check(blk, i, A, B, aidx, isA, ainv, r1, r2, bucket[blk], store, target, done);
+                }
+            #endif
+        }
+    }
+
+    // Trial-divide g(x) = (Y^2 - kN) / A with Y = Ax + B at a candidate position
+    void check(u32 blk, u32 off, const Big& A, const SBig& B, const std::vector<u32>& aidx,
+               const std::vector<u8>& isA, const std::vector<u32>& ainv, const std::vector<u32>& r1,
+               const std::vector<u32>& r2, const std::vector<u32>& bkt, RelationStore& store,
+               u64 target, std::atomic<bool>& done) const {
+        u32 pos = blk * BLOCK + off;
+        i64 x = (i64)pos - M;
+        SBig Y = SBig{mul_small(A, (u64)(x < 0 ? -x : x)), x < 0}.add(B);
+        Big Y2 = mul(Y.m, Y.m);
+        bool neg = cmp(Y2, kN) < 0;
+        Big Q = neg ? sub(kN, Y2) : sub(Y2, kN);
+        Big g;
+        divmod(Q, A, &g, nullptr);
+        if (g.zero()) return;
+
+        Relation rel;
+        if (neg) rel.f.push_back(0);
+        for (u32 j : aidx) rel.f.push_back(j);
+        auto divide_out = [&](u32 i) {
+            u32 p = fb[i];
+            while (mod_small(g, p) == 0) {
+                g = div_small(g, p);
+                rel.f.push_back(i);
+            }
+        };
+        for (u32 i = 1; i < large_cut; ++i) {
+            u32 p = fb[i];
+            if (!ainv[i] || i < small_cut) {
+                if (mod_small(g, p) == 0) divide_out(i);
+            } else {
+                u32 xm = pos % p;
+                if (xm == r1[i] || xm == r2[i]) divide_out(i);
+            }
+        }
+        for (u32 e : bkt)
+            if ((e & 0x7FFF) == off) divide_out(e >> 15);
+        for (u32 i = large_cut; i < fb.size(); ++i)      // A's own primes may sit up here
+            if (isA[i]) divide_out(i);
+
+        u64 large;
+        if (g.d.size() == 1 && g.d[0] == 1) large = 1;
+        else if (g.d.size() == 1 && g.d[0] < lp_bound) large = g.d[0];
+        else return;
+        rel.Y = Y.m;
+        if (store.add(std::move(rel), large, N) >= target) done = true;
+    }
+
+    Stats collect(RelationStore& store, u32 num_threads) const {
+        std::atomic<u64> next_a{0};
+        std::atomic<bool> done{false};
+        std::unordered_set<u64> seen_a;
+        std::mutex seen_mtx;
+        std::vector<Stats> local(num_threads);
+        u64 target = fb.size() + EXTRA_RELS;
+        std::vector<std::thread> threads;
+        for (u32 t = 0; t < num_threads; ++t)
+            threads.emplace_back([&, t] { worker(next_a, done, store, seen_a, seen_mtx, target, local[t]); });
+        for (auto& t : threads) t.join();
+        Stats st;
+        for (auto& l : local) { st.polys += l.polys; st.a_count += l.a_count; st.candidates += l.candidates; }
+        return st;
+    }
+};
+
+// ============================================================================
+// Linear algebra: singleton removal, then dense Gaussian elimination
+// ============================================================================
+// Rows are relations and columns factor base indices; a dependency is a set
+// of rows whose exponent vectors sum to zero mod 2. Columns hit by a single
+// row can never cancel, so that row is dropped and the count repeated until
+// no singletons are left; this usually removes most of the large fb primes.
+std::vector<std::vector<u32>> find_dependencies(const std::vector<Relation>& rels, size_t ncols,
+                                                size_t& rows_used, size_t& cols_used) {
+    std::vector<std::vector<u32>> odd(rels.size());
+    for (size_t r = 0; r < rels.size(); ++r) {
+        std::vector<u32> f = rels[r].f;
+        std::sort(f.begin(), f.end());
+        for (size_t i = 0; i < f.size(); ) {
+            size_t j = i;
+            while (j < f.size() && f[j] == f[i]) ++j;
+            if ((j - i) & 1) odd[r].push_back(f[i]);
+            i = j;
+        }
+    }
+    std::vector<u8> alive(rels.size(), 1);
+    std::vector<u32> weight(ncols);
+    for (bool changed = true; changed; ) {
+        changed = false;
+        std::fill(weight.begin(), weight.end(), 0);
+        for (size_t r = 0; r < rels.size(); ++r)
+            if (alive[r]) for (u32 c : odd[r]) ++weight[c];
+        for (size_t r = 0; r < rels.size(); ++r)
+            if (alive[r])
+                for (u32 c : odd[r])
+                    if (weight[c] == 1) { alive[r] = 0; changed = true; break; }
+    }
+    std::vector<u32> col_map(ncols, UINT32_MAX), rows;
+    u32 nc = 0;
+    for (size_t c = 0; c < ncols; ++c) if (weight[c]) col_map[c] = nc++;
+    for (size_t r = 0; r < rels.size(); ++r) if (alive[r]) rows.push_back((u32)r);
+    rows_used = rows.size();
+    cols_used = nc;
+
+    // Row = [matrix bits | identity bits] so a zero matrix part names its rows
+    size_t R = rows.size(), mw = (nc + 63) / 64, iw = (R + 63) / 64, W = mw + iw;
+    std::vector<u64> m(R * W, 0);
+    for (size_t r = 0; r < R; ++r) {
+        u64* row = &m[r * W];
+        for (u32 c : odd[rows[r]]) { u32 cc = col_map[c]; row[cc / 64] ^= 1ULL << (cc % 64); }
+        row[mw + r / 64] |= 1ULL << (r % 64);
+    }
+    std::vector<u8> pivoted(R, 0);
+    for (size_t c = 0; c < nc; ++c) {
+        size_t w = c / 64;
+        u64 bit = 1ULL << (c % 64);
+        size_t piv = R;
+        for (size_t r = 0; r < R; ++r)
+            if (!pivoted[r] && (m[r * W + w] & bit)) { piv = r; break; }
+        if (piv == R) continue;
+        pivoted[piv] = 1;
+        const u64* pr = &m[piv * W];
+        for (size_t r = 0; r < R; ++r) {
+            if (pivoted[r] || !(m[r * W + w] & bit)) continue;
+            u64* row = &m[r * W];
+            for (size_t k = w; k < W; ++k) row[k] ^= pr[k];
+        }
+    }
+    std::vector<std::vector<u32>> deps;
+    for (size_t r = 0; r < R && deps.size() < 64; ++r) {
+        if (pivoted[r]) continue;
+        std::vector<u32> dep;
+        const u64* row = &m[r * W + mw];
+        for (size_t j = 0; j < R; ++j)
+            if (row[j / 64] >> (j % 64) & 1) dep.push_back(rows[j]);
+        if (!dep.empty()) deps.push_back(std::move(dep));
+    }
+    return deps;
+}
+
+// ============================================================================
+// Square root: X = prod Y, Z = sqrt(prod Q) mod N, factor = gcd(X - Z, N)
+// ============================================================================
+Big try_dependency(const Siqs& sq, const std::vector<Relation>& rels, const std::vector<u32>& dep) {
+    const Big& N = sq.N;
+    std::vector<u32> e(sq.fb.size(), 0);
+    Big X(1), Z(1);
+    for (u32 r : dep) {
+        X = mulmod(X, rels[r].Y, N);
+        for (u32 i : rels[r].f) ++e[i];
+        for (u64 l : rels[r].lp) Z = mulmod(Z, Big(l), N);
+    }
+    for (size_t i = 1; i < e.size(); ++i) {
+        if (e[i] & 1) return Big();         // not a dependency after all
+        for (u32 j = 0; j < e[i] / 2; ++j) Z = mulmod(Z, Big(sq.fb[i]), N);
+    }
+    Big d = cmp(X, Z) >= 0 ? sub(X, Z) : sub(Z, X);
+    Big g = gcd(d, N);
+    if (cmp(g, Big(1)) == 0 || cmp(g, N) == 0) return Big();
+    return g;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    using namespace std::chrono;
+
+    std::vector<std::string> batch;
+    for (int i = 1; i < argc; ++i) batch.push_back(argv[i]);
+    if (batch.empty())
+        batch = {"627391505593440446666262389261",
+                 "5457698304123740990406905019938562903559",
+                 "72099399032753745367119096353964448931533599000041",
+                 "167179691131691133547162351904601521349712488776490506505803"};
+
+    u32 num_threads = std::thread::hardware_concurrency();
+    if (num_threads == 0) num_threads = 4;
+
+    std::cout << "=== SIQS Factoring Engine (" << batch.size() << " numbers, threads = " << num_threads << ") ===\n\n";
+    bool all_ok = true;
+
+    for (const auto& s : batch) {
+        Big N = from_dec(s);
+        std::cout << "N = " << to_dec(N) << " (" << to_dec(N).size() << " digits)\n";
+        if (to_dec(N).size() > MAX_DIGITS) {
+            std::cout << "  SKIPPED: above " << MAX_DIGITS << " digits\n\n";
+            all_ok = false;
+            continue;
+        }
+        auto t0 = high_resolution_clock::now();
+
+        Big fac;
+        Siqs sq(N);
+        if (!sq.factor_found.zero()) fac = sq.factor_found;
+        Siqs::Stats st;
+        RelationStore store;
+        double sieve_s = 0, la_ms = 0, sqrt_ms = 0;
+        size_t rows_used = 0, cols_used = 0, ndeps = 0;
+        if (fac.zero()) {
+            std::cout << "  multiplier " << sq.k << ", factor base " << sq.fb.size() << " (pmax " << sq.fb.back()
+                      << "), M = " << sq.M << ", A = " << sq.s_afact << " primes, threshold "
+                      << (int)sq.threshold << ", large primes < " << sq.lp_bound << "\n";
+            auto t1 = high_resolution_clock::now();
+            st = sq.collect(store, num_threads);
+            auto t2 = high_resolution_clock::now();
+            auto deps = find_dependencies(store.full, sq.fb.size(), rows_used, cols_used);
+            ndeps = deps.size();
+            auto t3 = high_resolution_clock::now();
+            for (auto& dep : deps)
+                if (!(fac = try_dependency(sq, store.full, dep)).zero()) break;
+            auto t4 = high_resolution_clock::now();
+            sieve_s = duration<double>(t2 - t1).count();
+            la_ms = duration<double, std::milli>(t3 - t2).count();
+            sqrt_ms = duration<double, std::milli>(t4 - t3).count();
+        }
+        double total_s = duration<double>(high_resolution_clock::now() - t0).count();
+
+        if (sieve_s > 0) {
+            u64 rels = store.n_full + store.n_partial;
+            std::cout << "  sieve:  " << std::fixed << std::setprecision(2) << sieve_s << " s, " << st.a_count
+                      << " A / " << st.polys << " polynomials, " << st.candidates << " candidates\n";
+            std::cout << "  relations: " << store.n_full << " full + " << store.n_combined << " combined from "
+                      << store.n_partial << " partials -> " << std::setprecision(0) << rels / sieve_s
+                      << " relations/s (" << (store.full.size()) / sieve_s << " usable/s)\n";
+            std::cout << "  matrix: " << rows_used << " x " << cols_used << " after singleton removal, "
+                      << ndeps << " dependencies, " << std::setprecision(1) << la_ms << " ms; sqrt "
+                      << sqrt_ms << " ms\n";
+        }
+        if (fac.zero()) {
+            std::cout << "  FAILED\n\n";
+            all_ok = false;
+            continue;
+        }
+        Big other;
+        Big rem;
+        divmod(N, fac, &other, &rem);
+        if (cmp(fac, other) > 0) std::swap(fac, other);
+        bool ok = rem.zero() && cmp(mul(fac, other), N) == 0;
+        all_ok &= ok;
+        std::cout << "  " << to_dec(fac) << (is_probable_prime(fac) ? " (prp)" : " (composite)") << " x "
+                  << to_dec(other) << (is_probable_prime(other) ? " (prp)" : " (composite)")
+                  << (ok ? "" : "  CHECK FAILED") << "\n";
+        std::cout << "  total " << std::setprecision(2) << total_s << " s\n\n";
+        std::cout.unsetf(std::ios::fixed);
+    }
+    return all_ok ? 0 : 1;
+}
@@ -8,6 +8,13 @@
 #include <thread>
 #include <vector>
 
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define HAS_AVX512 1
+#else
+#define HAS_AVX512 0
+#endif
+
 using u64 = uint64_t;
 using u32 = uint32_t;
 
@@ -31,6 +38,37 @@ std::vector<u32> base_sieve(u32 n) {
     return P;
 }
 
+// ============================================================================
+// Batch extraction: segment bitmap -> u64 primes
+// ============================================================================
+// Bit i of a segment starting at odd lo is lo + 2i; bits past the segment's
+// end must already be clear. AVX-512 decodes a byte per step by compressing
+// eight lane values with VPCOMPRESSQ and advancing by the byte's popcount,
+// so there is no per-prime branch; out needs 8 entries of slack.
+u64 extract_primes(const u64* seg, size_t words, u64 lo, u64* out) {
+    u64* o = out;
+#if HAS_AVX512
+    const __m512i lane = _mm512_setr_epi64(0, 2, 4, 6, 8, 10, 12, 14);
+    const __m512i step = _mm512_set1_epi64(16);
+    for (size_t i = 0; i < words; ++i) {
+        u64 w = seg[i];
+        if (!w) continue;
+        __m512i v = _mm512_add_epi64(_mm512_set1_epi64((long long)(lo + (i << 7))), lane);
+        for (u32 k = 0; k < 8; ++k) {
+            __mmask8 m = (__mmask8)(w >> (8 * k));
+            _mm512_storeu_si512(o, _mm512_maskz_compress_epi64(m, v));
+            o += __builtin_popcount(m);
+            v = _mm512_add_epi64(v, step);
+        }
+    }
+#else
+    for (size_t i = 0; i < words; ++i)
+        for (auto w = seg[i]; w; w &= w - 1)
+            *o++ = lo + (((i << 6) + __builtin_ctzll(w)) << 1);
+#endif
+    return o - out;
+}
+
 // ============================================================================
 // Segmented Bit-Packed Sieve (Single-threaded, cache-friendly)
 // ============================================================================
@@ -38,6 +76,7 @@ u64 sieve_segmented(u64 n, u64* last5) {
     constexpr u32 S = 1 << 17;  // 128K odds = 16KB segment (L1 cache)
     auto B = base_sieve((u32)std::sqrt((double)n) + 1);
     std::vector<u64> seg((S + 63) >> 6);
+    std::vector<u64> out(S + 8);
     u64 cnt = 0, pos = 0;
 
     auto add = [&](u64 p) { ++cnt; last5[pos++ % 5] = p; };
@@ -52,11 +91,11 @@ u64 sieve_segmented(u64 n, u64* last5) {
             for (u64 j = s; j <= hi; j += p << 1)
                 seg[(j - lo) >> 7] &= ~(1ULL << (((j - lo) >> 1) & 63));
         }
-        for (size_t i = 0; i < seg.size(); ++i)
-            for (auto w = seg[i]; w; w &= w - 1) {
-                u64 v = lo + (((i << 6) + __builtin_ctzll(w)) << 1);
-                if (v <= n) add(v);
-            }
+        u64 len = ((hi - lo) >> 1) + 1, words = (len + 63) >> 6;
+        if (len & 63) seg[words - 1] &= (1ULL << (len & 63)) - 1;
+        u64 m = extract_primes(seg.data(), words, lo, out.data());
+        cnt += m;
+        for (u64 j = m > 5 ? m - 5 : 0; j < m; ++j) last5[pos++ % 5] = out[j];
     }
     return cnt;
 }
@@ -120,12 +159,11 @@ u64 sieve_parallel(u64 n, u64* last5) {
         for (u64 j = s; j <= hi; j += p << 1)
             seg[(j - lo) >> 7] &= ~(1ULL << (((j - lo) >> 1) & 63));
     }
-    u32 pos = 0;
-    for (size_t i = 0; i < seg.size(); ++i)
-        for (auto w = seg[i]; w; w &= w - 1) {
-            u64 v = lo + (((i << 6) + __builtin_ctzll(w)) << 1);
-            if (v <= n) last5[pos++ % 5] = v;
-        }
+    u64 len = ((hi - lo) >> 1) + 1, words = (len + 63) >> 6;
+    if (len & 63) seg[words - 1] &= (1ULL << (len & 63)) - 1;
+    std::vector<u64> out(len + 8);
+    u64 m = extract_primes(seg.data(), words, lo, out.data());
+    for (u64 j = m > 5 ? m - 5 : 0, pos = 0; j < m; ++j) last5[pos++ % 5] = out[j];
     return cnt;
 }
 
@@ -6,17 +6,52 @@
 #include <algorithm>
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include <memory>
+#include <string>
+#include <cstring>
 #include <immintrin.h>
+#if defined(_MSC_VER)
 #include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
 
 using namespace std;
 using namespace std::chrono;
 
+// Kernels using wider ISAs than the build flags carry these, so a plain
+// -O3 build still holds every kernel and the CPU checks decide at runtime.
+// MSVC emits any intrinsic without flags.
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#define TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512cd,avx512vpopcntdq,popcnt")))
+#else
+#define TARGET_AVX2
+#define TARGET_AVX512
+#endif
+
 // ============================================================================
 // Platform Detection and CPU Feature Support
 // ============================================================================
 
+#if defined(_MSC_VER)
+inline void cpuid_ex(int out[4], int leaf, int sub) { __cpuidex(out, leaf, sub); }
+inline uint64_t xgetbv0() { return _xgetbv(0); }
+#else
+inline void cpuid_ex(int out[4], int leaf, int sub) {
+    unsigned a, b, c, d;
+    __cpuid_count(leaf, sub, a, b, c, d);
+    out[0] = (int)a; out[1] = (int)b; out[2] = (int)c; out[3] = (int)d;
+}
+inline uint64_t xgetbv0() {
+    uint32_t lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((uint64_t)hi << 32) | lo;
+}
+#endif
+
 struct CPUFeatures {
     bool sse2 = false;
     bool sse4_1 = false;
@@ -24,6 +59,11 @@ struct CPUFeatures {
     bool avx = false;
     bool avx2 = false;
     bool avx512f = false;
+    bool avx512bw = false;
+    bool avx512cd = false;
+    bool avx512vpopcntdq = false;
+    bool os_avx = false;        // XCR0 enables XMM + YMM state
+    bool os_avx512 = false;     // ... and opmask + ZMM state
     bool popcnt = false;
     bool bmi1 = false;
     bool bmi2 = false;
@@ -34,31 +74,47 @@ struct CPUFeatures {
         int cpuInfo[4];
         
         // Get vendor
-        __cpuid(cpuInfo, 0);
+        cpuid_ex(cpuInfo, 0, 0);
         int nIds = cpuInfo[0];
         
         // Get features
         if (nIds >= 1) {
-            __cpuid(cpuInfo, 1);
+            cpuid_ex(cpuInfo, 1, 0);
             sse2 = (cpuInfo[3] & (1 << 26)) != 0;
             sse4_1 = (cpuInfo[2] & (1 << 19)) != 0;
             sse4_2 = (cpuInfo[2] & (1 << 20)) != 0;
             avx = (cpuInfo[2] & (1 << 28)) != 0;
             popcnt = (cpuInfo[2] & (1 << 23)) != 0;
+            bool osxsave = (cpuInfo[2] & (1 << 27)) != 0;
+            uint64_t xcr0 = osxsave ? xgetbv0() : 0;
+            os_avx = (xcr0 & 0x6) == 0x6;
+            os_avx512 = (xcr0 & 0xE6) == 0xE6;
         }
         
         if (nIds >= 7) {
-            __cpuidex(cpuInfo, 7, 0);
+            cpuid_ex(cpuInfo, 7, 0);
             avx2 = (cpuInfo[1] & (1 << 5)) != 0;
             bmi1 = (cpuInfo[1] & (1 << 3)) != 0;
             bmi2 = (cpuInfo[1] & (1 << 8)) != 0;
             avx512f = (cpuInfo[1] & (1 << 16)) != 0;
+            avx512cd = (cpuInfo[1] & (1 << 28)) != 0;
+            avx512bw = (cpuInfo[1] & (1 << 30)) != 0;
+            avx512vpopcntdq = (cpuInfo[2] & (1 << 14)) != 0;
         }
         
         logical_cores = thread::hardware_concurrency();
         if (logical_cores == 0) logical_cores = 4;
     }
     
+    // Everything the AVX2 / AVX-512 segment kernels use
+    bool avx2_kernel() const {
+        return avx2 && popcnt && os_avx;
+    }
+    
+    bool avx512_kernel() const {
+        return avx512f && avx512bw && avx512cd && avx512vpopcntdq && os_avx512;
+    }
+    
     void print() const {
         cout << "CPU Features Detected:" << endl;
         cout << "  SSE2: " << (sse2 ? "YES" : "NO") << endl;
@@ -66,6 +122,8 @@ struct CPUFeatures {
         cout << "  AVX: " << (avx ? "YES" : "NO") << endl;
         cout << "  AVX2: " << (avx2 ? "YES" : "NO") << endl;
         cout << "  AVX-512F: " << (avx512f ? "YES" : "NO") << endl;
+        cout << "  AVX-512 BW/CD/VPOPCNTDQ: " << (avx512bw ? "YES" : "NO") << "/" << (avx512cd ? "YES" : "NO")
+             << "/" << (avx512vpopcntdq ? "YES" : "NO") << (os_avx512 ? "" : " (no OS ZMM support)") << endl;
         cout << "  POPCNT: " << (popcnt ? "YES" : "NO") << endl;
         cout << "  BMI1/BMI2: " << (bmi1 ? "YES" : "NO") << "/" << (bmi2 ? "YES" : "NO") << endl;
         cout << "  Logical Cores: " << logical_cores << endl;
@@ -78,7 +136,11 @@ static CPUFeatures g_cpu;
 // Bit Manipulation Helpers
 // ============================================================================
 
-#ifdef _WIN64
+#if defined(__GNUC__) || defined(__clang__)
+    inline int ctz32(uint32_t x) { return __builtin_ctz(x); }
+    inline int ctz64(uint64_t x) { return __builtin_ctzll(x); }
+    inline int popcount64(uint64_t x) { return __builtin_popcountll(x); }
+#elif defined(_WIN64)
     inline int ctz32(uint32_t x) {
         unsigned long index;
         _BitScanForward(&index, x);
@@ -223,7 +285,8 @@ private:
     }
     
 public:
-    vector<int> sieve(int n) override {
+    // Only constructed when g_cpu.avx2_kernel()
+    TARGET_AVX2 vector<int> sieve(int n) override {
         if (n < 2) return {};
         
         int bit_words = ((n >> 1) + 63) / 64;
@@ -253,7 +316,7 @@ public:
         
         // Process 4 words at a time with AVX2
         for (int i = 0; i < bit_words; i += 4) {
-            __m256i vec = _mm256_load_si256((__m256i*)&bits[i]);
+            __m256i vec = _mm256_loadu_si256((__m256i*)&bits[i]);   // vector storage is not 32-byte aligned
             
             if (!_mm256_testz_si256(vec, vec)) {
                 alignas(32) uint64_t temp[4];
@@ -280,25 +343,495 @@ public:
 };
 
 // ============================================================================
-// Parallel Segmented Sieve with Work Stealing
+// Segmented Sieve with Runtime-Dispatched Kernels
+// ============================================================================
+// Odd-only segments of 2^18 bits (bit k = 2k + 1). The per-segment work that
+// vectorizes lives in a SegmentKernel; one binary carries scalar, AVX2 and
+// AVX-512 versions and g_kernel picks the best one the CPU and OS support at
+// startup (or the one named on the command line).
+//   stamp:    a prime p < 64 strikes a word pattern with period p words
+//             (gcd(64, p) = 1); the 17 doubled cycles are ANDed 1/4/8 words
+//             at a time.
+//   popcount: sizes the segment's output.
+//   extract:  writes 2k + 1 for each set bit (ctz loop, or VPCOMPRESSD).
+// Primes from 67 up cross scalar with offsets carried across segments. The
+// AVX-512 kernel can also cross medium primes (64 < p < MEDIUM_LIMIT) with
+// gather/scatter, 8 lanes at a time, falling back to scalar on steps where
+// VPCONFLICTQ finds two active lanes on one word. That is off by default:
+// against scalar RMW on an L1-resident segment it is at best break-even
+// below p = 512 and clearly slower for larger cutoffs.
+
+static constexpr uint32_t STAMP_PRIMES[17] = {3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61};
+
+// Word i of cycle[q] is the mask for bits 64i..64i+63; 2p + 8 words so an
+// 8-word load from any start index < p never wraps
+struct StampTable {
+    vector<uint64_t> cycle[17];
+    
+    StampTable() {
+        for (int q = 0; q < 17; q++) {
+            uint32_t p = STAMP_PRIMES[q];
+            cycle[q].resize(2 * p + 8);
+            for (uint32_t i = 0; i < 2 * p + 8; i++) {
+                uint64_t w = ~0ULL;
+                for (uint32_t b = 0; b < 64; b++)
+                    if ((64 * i + b) % p == (p - 1) / 2) w &= ~(1ULL << b);
+                cycle[q][i] = w;
+            }
+        }
+    }
+};
+
+static const StampTable g_stamps;
+
+struct SegmentKernel {
+    const char* name;
+    bool (*supported)();
+    void (*stamp)(uint64_t* seg, uint64_t k0, uint32_t words);
+    uint64_t (*popcount)(const uint64_t* seg, uint32_t words);
+    int* (*extract)(const uint64_t* seg, uint64_t k0, uint32_t words, int* out);   // out needs 16 ints of slack
+    // Crosses base[i..i+8) below len and rebases offs[i..i+8); null if the kernel has none
+    void (*cross8)(uint64_t* seg, const uint32_t* base, uint64_t* offs, uint64_t len);
+};
+
+// ---- scalar ----
+
+static void stamp_scalar(uint64_t* seg, uint64_t k0, uint32_t words) {
+    uint32_t idx[17];
+    for (int q = 0; q < 17; q++) idx[q] = (uint32_t)((k0 >> 6) % STAMP_PRIMES[q]);
+    for (uint32_t w = 0; w < words; w++) {
+        uint64_t acc = ~0ULL;
+        for (int q = 0; q < 17; q++) {
+            acc &= g_stamps.cycle[q][idx[q]];
+            if (++idx[q] == STAMP_PRIMES[q]) idx[q] = 0;
+        }
+        seg[w] = acc;
+    }
+}
+
+static uint64_t popcount_scalar(const uint64_t* seg, uint32_t words) {
+    uint64_t c = 0;
+    for (uint32_t w = 0; w < words; w++) c += popcount64(seg[w]);
+    return c;
+}
+
+static int* extract_scalar(const uint64_t* seg, uint64_t k0, uint32_t words, int* out) {
+    for (uint32_t w = 0; w < words; w++)
+        for (uint64_t x = seg[w]; x; x &= x - 1)
+            *out++ = (int)(2 * (k0 + 64ULL * w + ctz64(x)) + 1);
+    return out;
+}
+
+// ---- AVX2 ----
+
+TARGET_AVX2 static void stamp_avx2(uint64_t* seg, uint64_t k0, uint32_t words) {
+    uint32_t idx[17];
+    for (int q = 0; q < 17; q++) idx[q] = (uint32_t)((k0 >> 6) % STAMP_PRIMES[q]);
+    uint32_t w = 0;
+    for (; w + 4 <= words; w += 4) {
+        __m256i acc = _mm256_set1_epi64x(-1LL);
+        for (int q = 0; q < 17; q++) {
+            uint32_t p = STAMP_PRIMES[q];
+            acc = _mm256_and_si256(acc, _mm256_loadu_si256((const __m256i*)(g_stamps.cycle[q].data() + idx[q])));
+            idx[q] += 4 % p;                        // p = 3 steps by 1
+            if (idx[q] >= p) idx[q] -= p;
+        }
+        _mm256_storeu_si256((__m256i*)(seg + w), acc);
+    }
+    for (; w < words; w++) {
+        uint64_t acc = ~0ULL;
+        for (int q = 0; q < 17; q++) {
+            acc &= g_stamps.cycle[q][idx[q]];
+            if (++idx[q] == STAMP_PRIMES[q]) idx[q] = 0;
+        }
+        seg[w] = acc;
+    }
+}
+
+TARGET_AVX2 static uint64_t popcount_avx2(const uint64_t* seg, uint32_t words) {
+    uint64_t c = 0;
+    for (uint32_t w = 0; w < words; w++) c += (uint64_t)_mm_popcnt_u64(seg[w]);
+    return c;
+}
+
+// ---- AVX-512 ----
+
+TARGET_AVX512 static void stamp_avx512(uint64_t* seg, uint64_t k0, uint32_t words) {
+    uint32_t idx[17];
+    for (int q = 0; q < 17; q++) idx[q] = (uint32_t)((k0 >> 6) % STAMP_PRIMES[q]);
+    for (uint32_t w = 0; w < words; w += 8) {
+        __m512i acc = _mm512_set1_epi64(-1LL);
+        for (int q = 0; q < 17; q++) {
+            uint32_t p = STAMP_PRIMES[q];
+            acc = _mm512_and_si512(acc, _mm512_loadu_si512(g_stamps.cycle[q].data() + idx[q]));
+            idx[q] += 8 % p;
+            if (idx[q] >= p) idx[q] -= p;
+        }
+        uint32_t rem = words - w;
+        __mmask8 m = rem >= 8 ? (__mmask8)0xFF : (__mmask8)((1u << rem) - 1);
+        _mm512_mask_storeu_epi64(seg + w, m, acc);
+    }
+}
+
+TARGET_AVX512 static uint64_t popcount_avx512(const uint64_t* seg, uint32_t words) {
+    __m512i acc = _mm512_setzero_si512();
+    uint32_t w = 0;
+    for (; w + 8 <= words; w += 8)
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_loadu_si512(seg + w)));
+    __mmask8 m = (__mmask8)((1u << (words - w)) - 1);
+    acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_maskz_loadu_epi64(m, seg + w)));
+    return (uint64_t)_mm512_reduce_add_epi64(acc);
+}
+
+TARGET_AVX512 static int* extract_avx512(const uint64_t* seg, uint64_t k0, uint32_t words, int* out) {
+    const __m512i lane = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+    const __m512i step = _mm512_set1_epi32(32);
+    for (uint32_t w = 0; w < words; w++) {
+        uint64_t x = seg[w];
+        if (!x) continue;
+        __m512i v = _mm512_add_epi32(_mm512_set1_epi32((int)(2 * (k0 + 64ULL * w) + 1)), lane);
+        for (int c = 0; c < 4; c++) {
+            __mmask16 m = (__mmask16)(x >> (16 * c));
+            _mm512_storeu_si512(out, _mm512_maskz_compress_epi32(m, v));
+            out += _mm_popcnt_u32(m);
+            v = _mm512_add_epi32(v, step);
+        }
+    }
+    return out;
+}
+
+TARGET_AVX512 static void cross8_avx512(uint64_t* seg, const uint32_t* base, uint64_t* offs, uint64_t len) {
+    const __m512i lenv = _mm512_set1_epi64((long long)len);
+    const __m512i one = _mm512_set1_epi64(1);
+    const __m512i low6 = _mm512_set1_epi64(63);
+    __m512i step = _mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i*)base));
+    __m512i idx = _mm512_loadu_si512(offs);
+    __mmask8 active = _mm512_cmplt_epu64_mask(idx, lenv);
+    while (active) {
+        __m512i word = _mm512_srli_epi64(idx, 6);
+        __m512i bit = _mm512_sllv_epi64(one, _mm512_and_si512(idx, low6));
+        __m512i conf = _mm512_maskz_conflict_epi64(active, word);
+        if (_mm512_mask_test_epi64_mask(active, conf, _mm512_set1_epi64(active))) {
+            alignas(64) uint64_t wv[8], bv[8];
+            _mm512_store_si512(wv, word);
+            _mm512_store_si512(bv, bit);
+            for (int l = 0; l < 8; l++)
+                if (active >> l & 1) seg[wv[l]] &= ~bv[l];
+        } else {
+            __m512i g = _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), active, word, seg, 8);
+            _mm512_mask_i64scatter_epi64(seg, active, word, _mm512_andnot_si512(bit, g), 8);
+        }
+        idx = _mm512_mask_add_epi64(idx, active, idx, step);
+        active = _mm512_mask_cmplt_epu64_mask(active, idx, lenv);
+    }
+    _mm512_storeu_si512(offs, _mm512_sub_epi64(idx, lenv));
+}
+
+// ---- dispatch ----
+
+static const SegmentKernel g_kernels[] = {
+    {"avx512", [] { return g_cpu.avx512_kernel(); }, stamp_avx512, popcount_avx512, extract_avx512, cross8_avx512},
+    {"avx2",   [] { return g_cpu.avx2_kernel(); },   stamp_avx2,   popcount_avx2,   extract_scalar, nullptr},
+    {"scalar", [] { return true; },                  stamp_scalar, popcount_scalar, extract_scalar, nullptr},
+};
+
+// Named kernel, or null if unknown or unsupported on this machine
+static const SegmentKernel* find_kernel(const string& name) {
+    for (const auto& k : g_kernels)
+        if (name == k.name) return k.supported() ? &k : nullptr;
+    return nullptr;
+}
+
+// Best supported kernel; the table is ordered widest first
+static const SegmentKernel* best_kernel() {
+    for (const auto& k : g_kernels)
+        if (k.supported()) return &k;
+    return &g_kernels[2];
+}
+
+static const SegmentKernel* g_kernel = best_kernel();
+
+// ---- streaming output ----
+// At 1e9 the prime list is ~200 MB that is written once and not read again
+// during the sieve. Regular stores fetch each destination line first (read
+// for ownership) and let it evict the segment and base-prime tables.
+// StreamWriter takes extracted primes in batches, stages a partial cache
+// line, and writes full 64-byte lines with MOVNTDQ, which bypasses the
+// cache. The destination must be pre-sized; the head up to the first line
+// boundary and the final partial line use ordinary stores.
+
+class StreamWriter {
+private:
+    int* dst;
+    alignas(64) int line[16];
+    size_t fill = 0;
+    
+    void flush_line(const int* src) {
+        for (int q = 0; q < 4; q++)
+            _mm_stream_si128((__m128i*)dst + q, _mm_loadu_si128((const __m128i*)src + q));
+        dst += 16;
+    }
+    
+public:
+    explicit StreamWriter(int* out) : dst(out) {}
+    
+    void append(const int* src, size_t count) {
+        while (count && (reinterpret_cast<uintptr_t>(dst) & 63)) {   // only before the first line
+            *dst++ = *src++;
+            count--;
+        }
+        if (fill) {
+            size_t take = min(16 - fill, count);
+            memcpy(line + fill, src, take * sizeof(int));
+            fill += take; src += take; count -= take;
+            if (fill < 16) return;
+            flush_line(line);
+            fill = 0;
+        }
+        for (; count >= 16; count -= 16, src += 16) flush_line(src);
+        memcpy(line, src, count * sizeof(int));
+        fill = count;
+    }
+    
+    // Writes the staged tail and orders the streamed stores; returns the end
+    int* finish() {
+        memcpy(dst, line, fill * sizeof(int));
+        dst += fill;
+        fill = 0;
+        _mm_sfence();
+        return dst;
+    }
+};
+
+enum class OutputMode { Count, Store, Stream };
+
+// Upper bound on pi(n): 1.25506 n / ln n for n > 1 (Rosser-Schoenfeld)
+inline size_t prime_count_bound(int n) {
+    return n < 2 ? 0 : (size_t)(1.25506 * n / log((double)n)) + 64;
+}
+
+class DispatchedSegmentedSieve : public ISieve {
+private:
+    static constexpr uint32_t SEG_BITS = 1u << 18;
+    static constexpr uint32_t SEG_WORDS = SEG_BITS / 64;
+    static constexpr uint32_t MEDIUM_LIMIT = 512;
+    static constexpr uint32_t STAGE_WORDS = 128;        // 8192 odds: never more primes than that
+    static constexpr size_t STREAM_MIN_BYTES = 4u << 20;  // sieve() streams output past this
+    
+    const SegmentKernel* kernel;
+    bool gather_medium;
+    string label;
+    vector<uint32_t> base;              // odd primes 67..sqrt(n)
+    vector<uint64_t> offs;              // next bit index, relative to the segment
+    vector<uint64_t> seg;
+    vector<int> stage;                  // streamed output, one batch at a time
+    
+    void cross_scalar(size_t i, uint64_t len) {
+        uint64_t* s = seg.data();
+        uint64_t p = base[i], k = offs[i];
+        for (; k < len; k += p) s[k >> 6] &= ~(1ULL << (k & 63));
+        offs[i] = k - len;
+    }
+    
+public:
+    // gather only applies to kernels with a cross8 entry
+    explicit DispatchedSegmentedSieve(const SegmentKernel* k = g_kernel, bool gather = false)
+        : kernel(k), gather_medium(gather && k->cross8) {
+        label = string("Segmented [") + kernel->name + (gather_medium ? ", gather crossing]" : "]");
+    }
+    
+    // Primes up to n into out, which must hold prime_count_bound(n) + 16 ints
+    // (Store) or prime_count_bound(n) (Stream); Count writes nothing
+    size_t sieve_into(int n, int* out, OutputMode mode) {
+        if (n < 2) return 0;
+        uint64_t nbits = ((uint64_t)n + 1) / 2;          // bit k <-> 2k + 1 <= n
+        uint32_t sqrt_n = (uint32_t)sqrt((double)n);
+        while ((uint64_t)(sqrt_n + 1) * (sqrt_n + 1) <= (uint64_t)n) sqrt_n++;
+        
+        // Base primes 67..sqrt(n) from a plain odd sieve
+        base.clear();
+        {
+            vector<uint8_t> comp(sqrt_n / 2 + 1, 0);
+            for (uint32_t i = 1; (2 * i + 1) * (2 * i + 1) <= sqrt_n; i++)
+                if (!comp[i])
+                    for (uint32_t j = 2 * i * (i + 1); j <= sqrt_n / 2; j += 2 * i + 1) comp[j] = 1;
+            for (uint32_t i = 33; i <= sqrt_n / 2; i++)
+                if (!comp[i] && 2 * i + 1 <= sqrt_n) base.push_back(2 * i + 1);
+        }
+        offs.resize(base.size() + 8);
+        for (size_t i = 0; i < base.size(); i++) offs[i] = ((uint64_t)base[i] * base[i] - 1) / 2;
+        size_t medium_end = 0;
+        while (medium_end < base.size() && base[medium_end] < MEDIUM_LIMIT) medium_end++;
+        size_t gather_end = gather_medium ? medium_end & ~(size_t)7 : 0;
+        seg.assign(SEG_WORDS, 0);
+        stage.resize(STAGE_WORDS * 64 + 16);
+        
+        const int two = 2;
+        StreamWriter writer(out);
+        int* end = out;
+        size_t count = 1;
+        if (mode == OutputMode::Stream) writer.append(&two, 1);
+        else if (mode == OutputMode::Store) *end++ = 2;
+        for (uint64_t k0 = 0; k0 < nbits; k0 += SEG_BITS) {
+            uint64_t len = min<uint64_t>(SEG_BITS, nbits - k0);
+            uint32_t words = (uint32_t)((len + 63) / 64);
+            kernel->stamp(seg.data(), k0, words);
+            if (k0 == 0) {
+                seg[0] &= ~1ULL;                            // 1 is not prime
+                for (uint32_t p : STAMP_PRIMES)             // the stamps struck p itself
+                    if (p <= (uint32_t)n) seg[(p / 2) >> 6] |= 1ULL << ((p / 2) & 63);
+            }
+            for (size_t i = 0; i < gather_end; i += 8)
+                kernel->cross8(seg.data(), base.data() + i, offs.data() + i, len);
+            for (size_t i = gather_end; i < base.size(); i++) cross_scalar(i, len);
+            if (len & 63) seg[words - 1] &= (1ULL << (len & 63)) - 1;
+            
+            if (mode == OutputMode::Count) {
+                count += kernel->popcount(seg.data(), words);
+            } else if (mode == OutputMode::Store) {
+                end = kernel->extract(seg.data(), k0, words, end);
+            } else {
+                for (uint32_t w = 0; w < words; w += STAGE_WORDS) {
+                    uint32_t cw = min(STAGE_WORDS, words - w);
+                    int* e = kernel->extract(seg.data() + w, k0 + 64ULL * w, cw, stage.data());
+                    writer.append(stage.data(), e - stage.data());
+                }
+            }
+        }
+        if (mode == OutputMode::Stream) end = writer.finish();
+        return mode == OutputMode::Count ? count : (size_t)(end - out);
+    }
+    
+    vector<int> sieve(int n) override {
+        if (n < 2) return {};
+        size_t bound = prime_count_bound(n);
+        OutputMode mode = bound * sizeof(int) >= STREAM_MIN_BYTES ? OutputMode::Stream : OutputMode::Store;
+        vector<int> primes(bound + 16);
+        primes.resize(sieve_into(n, primes.data(), mode));
+        return primes;
+    }
+    
+    const char* name() const override { return label.c_str(); }
+};
+
+// ============================================================================
+// Persistent Thread Pool
+// ============================================================================
+// Starting and joining threads on every call costs tens of microseconds per
+// thread, which shows at 1e7 where a whole parallel sieve takes a few ms.
+// The pool starts its workers once; they park on a condition variable
+// between jobs. run(count, fn) publishes fn(worker, task) for tasks
+// [0, count), wakes the workers, takes tasks itself as worker 0 and returns
+// when every worker has left the job. Workers spin on the generation for a
+// while before parking, so back-to-back jobs skip the futex wake. Worker ids
+// are stable, so callers can keep per-worker scratch across jobs.
+
+class ThreadPool {
+private:
+    using Job = function<void(int worker, int task)>;
+    
+    vector<thread> threads;
+    mutex m;
+    condition_variable wake, done;
+    atomic<uint64_t> generation{0};
+    atomic<int> next_task{0};
+    atomic<int> active{0};                  // workers not yet out of the job
+    const Job* job = nullptr;
+    int task_count = 0;
+    bool stop = false;
+    int spin;
+    
+    void drain(int worker) {
+        for (int t; (t = next_task.fetch_add(1, memory_order_relaxed)) < task_count; )
+            (*job)(worker, t);
+    }
+    
+    void loop(int worker) {
+        uint64_t seen = 0;
+        while (true) {
+            for (int i = 0; i < spin && generation.load(memory_order_acquire) == seen; i++)
+                _mm_pause();
+            if (generation.load(memory_order_acquire) == seen) {
+                unique_lock<mutex> lk(m);
+                wake.wait(lk, [&] { return stop || generation.load(memory_order_relaxed) != seen; });
+                if (stop) return;
+            }
+            seen = generation.load(memory_order_acquire);
+            drain(worker);
+            if (active.fetch_sub(1, memory_order_acq_rel) == 1) {
+                lock_guard<mutex> lk(m);
+                done.notify_one();
+            }
+        }
+    }
+    
+public:
+    // workers counts the caller; workers - 1 threads are started
+    explicit ThreadPool(int workers) : spin(workers > 1 && thread::hardware_concurrency() > 1 ? 4096 : 0) {
+        for (int i = 1; i < workers; i++) threads.emplace_back(&ThreadPool::loop, this, i);
+    }
+    
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lk(m);
+            stop = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads) t.join();
+    }
+    
+    int size() const { return (int)threads.size() + 1; }
+    
+    void run(int count, const Job& fn) {
+        job = &fn;
+        task_count = count;
+        next_task.store(0, memory_order_relaxed);
+        active.store((int)threads.size(), memory_order_relaxed);
+        {
+            lock_guard<mutex> lk(m);
+            generation.fetch_add(1, memory_order_release);
+        }
+        wake.notify_all();
+        drain(0);
+        for (int i = 0; i < spin && active.load(memory_order_acquire); i++) _mm_pause();
+        unique_lock<mutex> lk(m);
+        done.wait(lk, [&] { return active.load(memory_order_acquire) == 0; });
+    }
+};
+
+// Process-wide pool, one worker per logical core, started on first use
+ThreadPool& thread_pool() {
+    static ThreadPool pool(g_cpu.logical_cores);
+    return pool;
+}
+
+// ============================================================================
+// Parallel Segmented Sieve
 // ============================================================================
 
 class ParallelSegmentedSieve : public ISieve {
 private:
-    static constexpr int CACHE_LINE = 64;
     static constexpr int SEGMENT_SIZE = 262144;  // 256KB segments
-    vector<int> small_primes;
     
-    struct alignas(CACHE_LINE) WorkUnit {
-        atomic<int> next_segment{0};
-        int max_segment;
+    // Scratch kept across calls, one per worker
+    struct alignas(64) WorkerState {
+        vector<uint8_t> segment;
+        vector<int> primes;
     };
     
-    void sieve_segment(int low, int high, vector<uint8_t>& segment) {
+    ThreadPool* pool;                       // nullptr: start threads per call
+    int spawn_threads;
+    int min_parallel_n;
+    string label;
+    vector<int> small_primes;               // grows to the largest sqrt(n) seen
+    vector<WorkerState> states;
+    
+    void sieve_segment(int low, int high, size_t num_primes, vector<uint8_t>& segment) {
         int size = high - low + 1;
         memset(segment.data(), 1, size);
         
-        for (int p : small_primes) {
+        for (size_t i = 0; i < num_primes; i++) {
+            int p = small_primes[i];
             int start = ((low + p - 1) / p) * p;
             if (start == p) start = p * p;
             if (start > high) continue;
@@ -325,69 +858,79 @@ private:
     }
     
 public:
+    ParallelSegmentedSieve() : ParallelSegmentedSieve(&thread_pool(), 0, 1000000000) {}
+    
+    // Below min_parallel_n the bit-packed sieve runs instead; spawn_threads
+    // (0: one per logical core) applies only without a pool
+    ParallelSegmentedSieve(ThreadPool* pool, int spawn_threads, int min_parallel_n)
+        : pool(pool), spawn_threads(spawn_threads ? spawn_threads : g_cpu.logical_cores),
+          min_parallel_n(min_parallel_n),
+          label(pool ? "Parallel Segmented [pool]" : "Parallel Segmented [spawn]") {}
+    
     vector<int> sieve(int n) override {
         if (n < 2) return {};
         
         // For small n, use bit-packed version
-        if (n < 1000000000) {
+        if (n < min_parallel_n) {
             BitPackedUnrolledSieve bp;
             return bp.sieve(n);
         }
         
         int sqrt_n = static_cast<int>(sqrt(n));
         
-        // Find small primes up to sqrt(n)
-        BitPackedUnrolledSieve small_sieve;
-        small_primes = small_sieve.sieve(sqrt_n);
+        // Base primes up to sqrt(n), sieved again only when sqrt(n) grows
+        if (small_primes.empty() || small_primes.back() < sqrt_n) {
+            BitPackedUnrolledSieve small_sieve;
+            small_primes = small_sieve.sieve(max(sqrt_n, 2 * (small_primes.empty() ? 0 : small_primes.back())));
+        }
+        size_t num_primes = upper_bound(small_primes.begin(), small_primes.end(), sqrt_n) - small_primes.begin();
         
-        vector<int> all_primes = small_primes;
+        vector<int> all_primes(small_primes.begin(), small_primes.begin() + num_primes);
         all_primes.reserve(n / (log(n) - 1));
         
-        // Setup work units
-        WorkUnit work;
-        work.max_segment = (n - sqrt_n) / SEGMENT_SIZE + 1;
-        
-        int num_threads = min(g_cpu.logical_cores, work.max_segment);
-        vector<thread> threads;
-        vector<vector<int>> thread_primes(num_threads);
+        int max_segment = (n - sqrt_n) / SEGMENT_SIZE + 1;
+        int num_workers = pool ? pool->size() : min(spawn_threads, max_segment);
+        if ((int)states.size() < num_workers) states.resize(num_workers);
+        for (int w = 0; w < num_workers; w++) {
+            states[w].segment.resize(SEGMENT_SIZE);
+            states[w].primes.clear();
+        }
         
-        auto worker = [&](int thread_id) {
-            vector<uint8_t> segment(SEGMENT_SIZE);
-            vector<int>& local_primes = thread_primes[thread_id];
-            local_primes.reserve(SEGMENT_SIZE / 10);
+        auto task = [&](int worker, int seg_idx) {
+            WorkerState& st = states[worker];
+            int low = sqrt_n + 1 + seg_idx * SEGMENT_SIZE;
+            int high = min(low + SEGMENT_SIZE - 1, n);
             
-            while (true) {
-                int seg_idx = work.next_segment.fetch_add(1);
-                if (seg_idx >= work.max_segment) break;
-                
-                int low = sqrt_n + 1 + seg_idx * SEGMENT_SIZE;
-                int high = min(low + SEGMENT_SIZE - 1, n);
-                
-                sieve_segment(low, high, segment);
-                
-                // Collect primes
-                int size = high - low + 1;
-                for (int i = 0; i < size; i++) {
-                    if (segment[i]) {
-                        local_primes.push_back(low + i);
-                    }
+            sieve_segment(low, high, num_primes, st.segment);
+            
+            // Collect primes
+            int size = high - low + 1;
+            for (int i = 0; i < size; i++) {
+                if (st.segment[i]) {
+                    st.primes.push_back(low + i);
                 }
             }
         };
         
-        // Launch threads
-        for (int i = 0; i < num_threads; i++) {
-            threads.emplace_back(worker, i);
-        }
-        
-        // Wait for completion
-        for (auto& t : threads) {
-            t.join();
+        if (pool) {
+            pool->run(max_segment, task);
+        } else {
+            atomic<int> next_segment{0};
+            vector<thread> threads;
+            for (int w = 0; w < num_workers; w++) {
+                threads.emplace_back([&, w] {
+                    for (int seg_idx; (seg_idx = next_segment.fetch_add(1)) < max_segment; )
+                        task(w, seg_idx);
+                });
+            }
+            for (auto& t : threads) {
+                t.join();
+            }
         }
         
         // Merge results
-        for (const auto& tp : thread_primes) {
-            all_primes.insert(all_primes.end(), tp.begin(), tp.end());
+        for (int w = 0; w < num_workers; w++) {
+            all_primes.insert(all_primes.end(), states[w].primes.begin(), states[w].primes.end());
         }
         
         sort(all_primes.begin(), all_primes.end());
@@ -395,7 +938,7 @@ public:
         return all_primes;
     }
     
-    const char* name() const override { return "Parallel Segmented"; }
+    const char* name() const override { return label.c_str(); }
 };
 
 // ============================================================================
@@ -476,27 +1019,13 @@ private:
         }
         
         // For large scale (10M-100M)
-        if (n > 10000000) {
-            if (g_cpu.logical_cores >= 8) {
-                return make_unique<ParallelSegmentedSieve>();
-            } else if (g_cpu.avx2) {
-                return make_unique<AVX2OptimizedSieve>();
-            } else {
-                return make_unique<BitPackedUnrolledSieve>();
-            }
-        }
-        
-        // For medium scale (1M-10M)
-        if (n > 1000000) {
-            if (g_cpu.avx2) {
-                return make_unique<AVX2OptimizedSieve>();
-            } else {
-                return make_unique<BitPackedUnrolledSieve>();
-            }
+        if (n > 10000000 && g_cpu.logical_cores >= 8) {
+            return make_unique<ParallelSegmentedSieve>();
         }
         
-        // For small scale (<1M)
-        return make_unique<BitPackedUnrolledSieve>();
+        // Single-threaded, the segmented sieve beats the flat ones at every
+        // size, even with the scalar kernel (3-4x at 1e7..5e7)
+        return make_unique<DispatchedSegmentedSieve>();
     }
     
 public:
@@ -534,17 +1063,93 @@ void benchmark(ISieve* sieve, int n, int runs = 3) {
          << "found " << result.size() << " primes" << endl;
 }
 
+// Cost of one parallel call with threads started and joined per call
+// against the persistent pool: an empty job on `workers` workers, then the
+// parallel sieve on one worker per logical core
+void benchmark_dispatch(int workers) {
+    ThreadPool pool(workers);
+    constexpr int REPS = 1000;
+    auto t0 = high_resolution_clock::now();
+    for (int r = 0; r < REPS; r++) {
+        vector<thread> threads;
+        for (int w = 0; w < workers; w++) threads.emplace_back([] {});
+        for (auto& t : threads) t.join();
+    }
+    auto t1 = high_resolution_clock::now();
+    for (int r = 0; r < REPS; r++) pool.run(workers, [](int, int) {});
+    auto t2 = high_resolution_clock::now();
+    cout << "Empty job, " << workers << " workers: spawn/join " << duration_cast<nanoseconds>(t1 - t0).count() / 1000.0 / REPS
+         << " us, pool " << duration_cast<nanoseconds>(t2 - t1).count() / 1000.0 / REPS << " us" << endl;
+    
+    ParallelSegmentedSieve spawned(nullptr, 0, 0), pooled(&thread_pool(), 0, 0);
+    for (int n : {1000000, 10000000}) {
+        benchmark(&spawned, n, 10);
+        benchmark(&pooled, n, 10);
+    }
+}
+
+// Sieve throughput while the prime list is written: count only, regular
+// stores and streaming stores into the same pre-faulted buffer
+bool benchmark_output(int n, int runs) {
+    DispatchedSegmentedSieve sieve;
+    size_t bound = prime_count_bound(n) + 16;
+    unique_ptr<int[]> out(new int[bound]);
+    memset(out.get(), 0, bound * sizeof(int));      // fault the pages in up front
+    
+    const pair<const char*, OutputMode> modes[] = {
+        {"count only", OutputMode::Count},
+        {"regular stores", OutputMode::Store},
+        {"streaming stores", OutputMode::Stream},
+    };
+    size_t ref_count = 0;
+    uint64_t ref_sum = 0;
+    bool ok = true;
+    for (const auto& m : modes) {
+        double best = 1e30;
+        size_t count = 0;
+        for (int r = 0; r < runs; r++) {
+            auto start = high_resolution_clock::now();
+            count = sieve.sieve_into(n, out.get(), m.second);
+            auto end = high_resolution_clock::now();
+            best = min(best, duration_cast<microseconds>(end - start).count() / 1000.0);
+        }
+        if (m.second == OutputMode::Count) {
+            ref_count = count;
+        } else {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < count; i++) sum = sum * 31 + out[i];
+            if (m.second == OutputMode::Store) ref_sum = sum;
+            ok &= count == ref_count && sum == ref_sum;
+        }
+        cout << "  " << m.first << ": " << best << " ms ("
+             << n / best / 1000 << " M/s), " << count << " primes" << endl;
+    }
+    return ok;
+}
+
 // ============================================================================
 // Main
 // ============================================================================
 
-int main() {
+// Usage: c-primes-the-beast [--kernel=avx512|avx2|scalar]
+// The named segment kernel replaces the startup pick; it must be supported.
+int main(int argc, char** argv) {
     cout << "Ultimate Prime Sieve - Maximum Performance Edition" << endl;
     cout << "==================================================" << endl;
     
     // Detect CPU features
     g_cpu.print();
     
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--kernel=", 9) != 0) continue;
+        g_kernel = find_kernel(argv[i] + 9);
+        if (!g_kernel) {
+            cerr << "Unknown or unsupported kernel: " << (argv[i] + 9) << endl;
+            return 1;
+        }
+    }
+    cout << "Segment kernel: " << g_kernel->name << endl;
+    
     // Test scales
     vector<int> test_sizes = {500000, 10000000, 50000000};
     
@@ -557,10 +1162,16 @@ int main() {
         vector<unique_ptr<ISieve>> sieves;
         sieves.push_back(make_unique<BitPackedUnrolledSieve>());
         
-        if (g_cpu.avx2) {
+        if (g_cpu.avx2_kernel()) {
             sieves.push_back(make_unique<AVX2OptimizedSieve>());
         }
         
+        for (const auto& k : g_kernels) {
+            if (!k.supported()) continue;
+            sieves.push_back(make_unique<DispatchedSegmentedSieve>(&k));
+            if (k.cross8) sieves.push_back(make_unique<DispatchedSegmentedSieve>(&k, true));
+        }
+        
         if (n >= 10000000 && g_cpu.logical_cores >= 4) {
             sieves.push_back(make_unique<ParallelSegmentedSieve>());
         }
@@ -573,6 +1184,12 @@ int main() {
         }
     }
     
+    // Dispatch
+    cout << "\n" << string(50, '-') << endl;
+    cout << "Dispatch (" << g_cpu.logical_cores << " logical cores):" << endl;
+    cout << string(50, '-') << endl;
+    benchmark_dispatch(4);
+    
     // Verify correctness
     cout << "\n" << string(50, '-') << endl;
     cout << "Verification (first 20 primes):" << endl;
@@ -583,6 +1200,14 @@ int main() {
     }
     cout << endl;
     
+    // Output path
+    cout << "\n" << string(50, '-') << endl;
+    cout << "Output path (n = 1,000,000,000, best of 3):" << endl;
+    cout << string(50, '-') << endl;
+    bool output_ok = benchmark_output(1000000000, 3);
+    cout << "────────────────────────" << endl;
+    cout << "Verify output modes: " << (output_ok ? "OK" : "MISMATCH") << endl;
+    
     // SHA256-scale demonstration
     cout << "\n" << string(50, '-') << endl;
     cout << "Cryptographic Scale Demo (n = 100,000,000):" << endl;
@@ -599,5 +1224,5 @@ int main() {
     cout << "Rate: " << (100000000.0 / duration.count()) / 1000 
          << " million numbers/second" << endl;
     
-    return 0;
+    return output_ok ? 0 : 1;
 }
\ No newline at end of file
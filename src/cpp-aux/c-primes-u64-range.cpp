@@ -0,0 +1,320 @@
+// c-primes-u64-range.cpp
+// Range sieve over the full u64 domain, e.g. [2^64 - 1e10, 2^64 - 1]
+// Compile: g++ -O3 -march=native -std=c++17 c-primes-u64-range.cpp -o c-primes-u64-range
+// Usage:   c-primes-u64-range [width] [lo]   (default: width = 1e9, lo = 2^64 - width)
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using u64 = uint64_t;
+using u32 = uint32_t;
+using u8  = uint8_t;
+using u128 = unsigned __int128;
+
+inline int ctz64(u64 x) { return __builtin_ctzll(x); }
+
+// ============================================================================
+// Base sieve for primes up to sqrt(n)
+// ============================================================================
+std::vector<u32> base_sieve(u32 n) {
+    u32 h = n / 2 + 1;
+    std::vector<u64> b((h + 63) >> 6, ~0ULL);
+    b[0] ^= 1;
+    for (u32 i = 1, L = (u32)std::sqrt(n) / 2; i <= L; ++i)
+        if (b[i >> 6] >> (i & 63) & 1)
+            for (u32 j = 2*i*(i+1), s = 2*i+1; j < h; j += s)
+                b[j >> 6] &= ~(1ULL << (j & 63));
+    std::vector<u32> P{2};
+    for (u32 i = 0; i < b.size(); ++i)
+        for (auto w = b[i]; w; w &= w - 1) {
+            u32 v = ((i << 6) + ctz64(w)) * 2 + 1;
+            if (v > 1 && v <= n) P.push_back(v);
+        }
+    return P;
+}
+
+// Exact floor(sqrt(n)) for any u64 (fits u32; the double estimate can be off by one)
+u32 isqrt64(u64 n) {
+    u64 r = (u64)std::sqrt((long double)n);
+    while ((u128)r * r > n) --r;
+    while ((u128)(r + 1) * (r + 1) <= n) ++r;
+    return (u32)r;
+}
+
+// First odd multiple of p that is >= max(lo, p*p), or 0 if it lies past hi.
+// Done in 128 bits: lo + p - 1 and p*p both overflow u64 near 2^64. The
+// parity fix-up is a mask rather than a branch since it is a coin flip.
+inline u64 first_odd_multiple(u64 p, u64 lo, u64 hi) {
+    u64 r = lo % p;
+    u128 s = (u128)lo + (r ? p - r : 0);
+    s += p & ((u64)(s & 1) - 1);
+    u128 p2 = (u128)p * p;
+    if (s < p2) s = p2;
+    return s > hi ? 0 : (u64)s;
+}
+
+// ============================================================================
+// Segmented base primes up to 2^32
+// ============================================================================
+// Primes below small_limit are kept as u32 and swept per L2 segment; the rest
+// (up to ~2^32, i.e. 203M primes near 2^64) are kept as half-gaps in one byte
+// each. The largest prime gap below 2^32 is 336, so gap/2 always fits a u8.
+struct BasePrimes {
+    std::vector<u32> small;   // odd primes < small_limit
+    std::vector<u8>  gaps;    // half-gaps of odd primes in [small_limit, limit]
+    u32 first_large = 0;      // first prime >= small_limit (gaps start after it)
+    u64 large_count = 0;
+    u32 limit = 0;            // every prime <= limit is present
+};
+
+BasePrimes segmented_base_primes(u32 limit, u32 small_limit) {
+    constexpr u32 S = 1 << 20;  // 1M odds = 128KB per segment
+    BasePrimes bp;
+    bp.limit = limit;
+    auto P = base_sieve(1u << 16);  // Enough to sieve anything below 2^32
+    std::vector<u64> seg(S >> 6);
+    u32 prev = 0;
+
+    auto emit = [&](u32 v) {
+        if (v < small_limit) { bp.small.push_back(v); return; }
+        if (!bp.large_count++) bp.first_large = v;
+        else bp.gaps.push_back((u8)((v - prev) >> 1));
+        prev = v;
+    };
+
+    for (size_t i = 1; i < P.size() && P[i] <= limit; ++i) emit(P[i]);
+
+    for (u64 lo = 1u << 16 | 1; lo <= limit; lo += (u64)S << 1) {
+        u64 hi = std::min(lo + ((u64)S << 1) - 2, (u64)limit);
+        u64 seg_size = ((hi - lo) >> 1) + 1;
+        std::fill(seg.begin(), seg.end(), ~0ULL);
+        for (size_t i = 1; i < P.size(); ++i) {
+            u64 s = first_odd_multiple(P[i], lo, hi);
+            if (!s) continue;
+            for (u64 idx = (s - lo) >> 1; idx < seg_size; idx += P[i])
+                seg[idx >> 6] &= ~(1ULL << (idx & 63));
+        }
+        for (size_t i = 0; i < seg.size(); ++i)
+            for (auto w = seg[i]; w; w &= w - 1) {
+                u64 idx = (i << 6) + ctz64(w);
+                if (idx < seg_size) emit((u32)(lo + (idx << 1)));
+            }
+    }
+    return bp;
+}
+
+// ============================================================================
+// Range sieve: [lo, hi] anywhere in [0, 2^64 - 1]
+// ============================================================================
+// The window is processed in blocks of at most BLOCK odds. Small base primes
+// keep a running offset and are swept over each L2 segment of the block; the
+// large ones (at most a few hits per block) are streamed from the gap table
+// once per block and crossed straight into the block bitmap.
+//
+// on_block(block_lo, bits, nbits): bit i set <=> block_lo + 2i is prime.
+// 2 is reported through on_two() since the bitmap holds odd values only.
+//
+// The base primes are built once by base_primes() and shared: near 2^64 the
+// table is ~193 MB and takes seconds, so every window sieves from a table
+// that covers at least isqrt(hi) and only walks it up to that point.
+class RangeSieve {
+public:
+    static constexpr u32 SEG = 1 << 21;           // 2M odds = 256KB (L2)
+    static constexpr u64 BLOCK = (u64)SEG << 9;   // 1G odds = 128MB bitmap
+
+    static BasePrimes base_primes(u64 hi) {
+        u32 limit = isqrt64(hi);
+        return segmented_base_primes(limit, std::min<u64>((u64)SEG << 1, limit + 1ULL));
+    }
+
+    // bp.limit must be >= isqrt64(hi)
+    RangeSieve(const BasePrimes& bp, u64 lo, u64 hi) : lo_(lo), hi_(hi), limit_(isqrt64(hi)), bp_(bp) {}
+
+    template <class Two, class Block>
+    void run(Two on_two, Block on_block) {
+        if (hi_ < lo_ || hi_ < 2) return;
+        if (lo_ <= 2) on_two();
+        u64 lo = std::max<u64>(lo_, 3) | 1;  // First odd >= max(lo, 3)
+        if (lo < lo_ || lo > hi_) return;    // Wrapped or empty
+
+        u64 span = ((hi_ - lo) >> 1) + 1;    // Odd values in [lo, hi]
+        size_t n_small = std::upper_bound(bp_.small.begin(), bp_.small.end(), limit_) - bp_.small.begin();
+        std::vector<u64> bits((std::min(span, BLOCK) + 63) >> 6);
+        std::vector<u64> next(n_small);
+
+        for (u64 done = 0; done < span; ) {
+            u64 nbits = std::min(span - done, BLOCK);
+            u64 b_lo = lo + (done << 1);
+            u64 b_hi = b_lo + ((nbits - 1) << 1);
+            u64 words = (nbits + 63) >> 6;
+            std::fill(bits.begin(), bits.begin() + words, ~0ULL);
+
+            // Small primes: start offsets once per block, then L2 sweeps
+            for (size_t i = 0; i < n_small; ++i) {
+                u64 s = first_odd_multiple(bp_.small[i], b_lo, b_hi);
+                next[i] = s ? (s - b_lo) >> 1 : ~0ULL;
+            }
+            for (u64 seg_lo = 0; seg_lo < nbits; seg_lo += SEG) {
+                u64 seg_hi = std::min(seg_lo + SEG, nbits);
+                for (size_t i = 0; i < n_small; ++i) {
+                    u64 p = bp_.small[i], idx = next[i];
+                    for (; idx < seg_hi; idx += p)
+                        bits[idx >> 6] &= ~(1ULL << (idx & 63));
+                    next[i] = idx;
+                }
+            }
+
+            // Large primes: decode the gap table, <= a handful of hits each.
+            // Their first hits land all over the block, so each start is
+            // prefetched and crossed LAG primes later to overlap the misses.
+            if (bp_.large_count && bp_.first_large <= limit_) {
+                constexpr u32 LAG = 16;
+                u64 lag_p[LAG] = {}, lag_idx[LAG];
+                std::fill(lag_idx, lag_idx + LAG, nbits);
+                u64 p = bp_.first_large;
+                for (u64 k = 0; ; ++k) {
+                    u64 s = first_odd_multiple(p, b_lo, b_hi);
+                    u64 idx = s ? (s - b_lo) >> 1 : nbits;
+                    if (s) __builtin_prefetch(&bits[idx >> 6], 1);
+                    u32 slot = k % LAG;
+                    for (u64 j = lag_idx[slot], q = lag_p[slot]; j < nbits; j += q)
+                        bits[j >> 6] &= ~(1ULL << (j & 63));
+                    lag_p[slot] = p;
+                    lag_idx[slot] = idx;
+                    if (k == bp_.gaps.size()) break;
+                    p += (u64)bp_.gaps[k] << 1;
+                    if (p > limit_) break;
+                }
+                for (u32 slot = 0; slot < LAG; ++slot)
+                    for (u64 j = lag_idx[slot], q = lag_p[slot]; j < nbits; j += q)
+                        bits[j >> 6] &= ~(1ULL << (j & 63));
+            }
+
+            on_block(b_lo, bits.data(), nbits);
+            done += nbits;
+        }
+    }
+
+    u64 count() {
+        u64 cnt = 0;
+        run([&] { ++cnt; }, [&](u64, const u64* bits, u64 nbits) {
+            u64 words = nbits >> 6;
+            for (u64 i = 0; i < words; ++i) cnt += __builtin_popcountll(bits[i]);
+            if (nbits & 63) cnt += __builtin_popcountll(bits[words] & ((1ULL << (nbits & 63)) - 1));
+        });
+        return cnt;
+    }
+
+private:
+    u64 lo_, hi_;
+    u32 limit_;
+    const BasePrimes& bp_;
+};
+
+// ============================================================================
+// Deterministic Miller-Rabin for u64 (verification only)
+// ============================================================================
+u64 mulmod(u64 a, u64 b, u64 m) { return (u64)((u128)a * b % m); }
+
+u64 powmod(u64 a, u64 e, u64 m) {
+    u64 r = 1;
+    for (a %= m; e; e >>= 1, a = mulmod(a, a, m))
+        if (e & 1) r = mulmod(r, a, m);
+    return r;
+}
+
+bool is_prime_mr(u64 n) {
+    if (n < 2) return false;
+    for (u64 p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37})
+        if (n % p == 0) return n == p;
+    u64 d = n - 1;
+    int s = ctz64(d);
+    d >>= s;
+    for (u64 a : {2, 325, 9375, 28178, 450775, 9780504, 1795265022}) {
+        u64 x = powmod(a, d, n);
+        if (x == 0 || x == 1 || x == n - 1) continue;
+        bool composite = true;
+        for (int r = 1; r < s && composite; ++r)
+            composite = (x = mulmod(x, x, n)) != n - 1;
+        if (composite) return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    using namespace std::chrono;
+
+    constexpr u64 U64_MAX = ~0ULL;
+    u64 width = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000'000ULL;
+    if (width == 0) {
+        std::cerr << "width must be at least 1\n";
+        return 1;
+    }
+    u64 lo = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : U64_MAX - width + 1;
+    u64 hi = (U64_MAX - lo < width - 1) ? U64_MAX : lo + width - 1;
+
+    std::cout << "=== u64 Range Sieve [" << lo << ", " << hi << "] ===\n";
+
+    // One base-prime table up to 2^32 serves every window below
+    auto t0 = high_resolution_clock::now();
+    const BasePrimes bp = RangeSieve::base_primes(U64_MAX);
+    auto t1 = high_resolution_clock::now();
+
+    // Verification: a small window at the very top of u64 vs Miller-Rabin
+    {
+        u64 v_lo = U64_MAX - 99'999;
+        u64 expect = 0;
+        for (u64 v = v_lo; ; ++v) { expect += is_prime_mr(v); if (v == U64_MAX) break; }
+        u64 got = RangeSieve(bp, v_lo, U64_MAX).count();
+        std::cout << "Verify [2^64 - 1e5, 2^64 - 1]: sieve " << got << ", Miller-Rabin " << expect
+                  << (got == expect ? "  OK\n" : "  MISMATCH\n");
+        if (got != expect) return 1;
+    }
+
+    // Last 5 primes below 2^64 (18446744073709551557 is the largest)
+    {
+        std::array<u64, 5> ring{};
+        u64 pos = 0;
+        RangeSieve(bp, U64_MAX - 999, U64_MAX).run([] {}, [&](u64 b_lo, const u64* bits, u64 nbits) {
+            for (u64 i = 0; i < ((nbits + 63) >> 6); ++i)
+                for (auto w = bits[i]; w; w &= w - 1) {
+                    u64 idx = (i << 6) + ctz64(w);
+                    if (idx < nbits) ring[pos++ % 5] = b_lo + (idx << 1);
+                }
+        });
+        std::cout << "Last 5 below 2^64: ";
+        for (u64 i = 0; i < 5; ++i) std::cout << ring[(pos + i) % 5] << ' ';
+        std::cout << "\n\n";
+    }
+
+    // High window vs low window of the same width, both on the shared table
+    auto t2 = high_resolution_clock::now();
+    u64 high_cnt = RangeSieve(bp, lo, hi).count();
+    auto t3 = high_resolution_clock::now();
+    u64 low_cnt = RangeSieve(bp, 0, hi - lo).count();
+    auto t4 = high_resolution_clock::now();
+
+    auto base_ms = duration_cast<milliseconds>(t1 - t0).count();
+    auto high_ms = duration_cast<milliseconds>(t3 - t2).count();
+    auto low_ms = duration_cast<milliseconds>(t4 - t3).count();
+
+    std::cout << "Base primes:  " << bp.small.size() + bp.large_count
+              << " up to " << bp.limit << " (" << bp.gaps.size() / (1 << 20)
+              << " MB gap table)\n";
+    std::cout << "Base sieve:   " << base_ms << " ms\n";
+    std::cout << "High window:  " << high_ms << " ms, " << high_cnt << " primes\n";
+    std::cout << "Low window:   " << low_ms << " ms, " << low_cnt << " primes in [0, " << hi - lo << "]\n";
+    std::cout << "─────────────────────\n";
+    std::cout << "High/low time ratio: " << (double)high_ms / (low_ms ? low_ms : 1) << "x\n";
+    std::cout << "High throughput:     " << ((hi - lo) / (high_ms ? high_ms : 1)) / 1000 << " million/sec\n";
+    return 0;
+}
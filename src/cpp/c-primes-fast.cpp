@@ -3,6 +3,8 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <cstdint>
+#include <algorithm>
 #include <omp.h>
 
 // Helper macros for bit manipulation
@@ -10,7 +12,18 @@
 #define CLEAR_BIT(arr, idx) (arr[(idx) >> 6] &= ~(1ULL << ((idx) & 63)))
 #define TEST_BIT(arr, idx)  (arr[(idx) >> 6] & (1ULL << ((idx) & 63)))
 
+// Threads own whole cache lines of the bitmap (8 words = 64 bytes), so no
+// two threads ever write the same word or line, and each sweeps its block in
+// L1-sized chunks.
+constexpr std::size_t LINE_WORDS = 8;
+constexpr std::size_t CHUNK_WORDS = 4096;   // 32 KB
+
 // This function returns a list of primes up to n.
+// Index i of the bitset is the odd number 2*i + 1. The base primes up to
+// sqrt(n) come from a small serial sieve; then every thread sieves its own
+// block of the bitmap with all of them and extracts its block's primes into
+// a slot found by a prefix sum over the per-thread counts. There is no
+// shared write anywhere, so nothing needs to be atomic.
 std::vector<unsigned long long> sieve_odd_bitset_parallel(unsigned long long n) {
     if (n < 2) {
         return {};
@@ -19,60 +32,84 @@ std::vector<unsigned long long> sieve_odd_bitset_parallel(unsigned long long n)
         return {2ULL};
     }
 
-    // We'll store only odd numbers in the bitset.
-    // Index i corresponds to the odd number = 2*i + 1.
-    // So we need (n+1)/2 bits to represent all odd numbers up to n.
-    // We'll skip 0 and 1 as well, but that's minor overhead.
-
-    unsigned long long size = (n >> 1) + 1; // roughly (n/2 + 1)
-    // Each 64-bit block can hold 64 bits
-    std::vector<unsigned long long> bitset((size + 63) / 64, 0ULL);
-
-    // Initialize all bits to 1 (mark as potential primes) except index 0 => number 1 => not prime
-    // We'll do this by setting them all, then clearing the 1 index.
-    #pragma omp parallel for
-    for (std::size_t i = 0; i < bitset.size(); i++) {
-        bitset[i] = 0xFFFFFFFFFFFFFFFFULL; // set all 64 bits to 1
-    }
-    CLEAR_BIT(bitset, 0);  // index 0 corresponds to number 1 (not prime)
+    // Bits 0 .. nbits-1 cover the odd numbers 1 .. n
+    unsigned long long nbits = (n + 1) >> 1;
+    std::size_t words = (nbits + 63) / 64;
 
-    // Now let's do the sieve
+    // Odd base primes up to sqrt(n)
     unsigned long long limit = (unsigned long long)std::sqrt((long double)n);
-
-    // We handle p=2 separately:
-    // 2 is prime, but we're only marking odd numbers in the bitset.
-    // We'll skip marking multiples of 2. (Though you could if you want.)
-
-    // For p = 3, 5, 7, ..., up to limit
-    // index i => p = 2*i+1
-    unsigned long long max_i = (limit >> 1);
-    
-    // Parallel outer loop
-    #pragma omp parallel for schedule(dynamic)
-    for (long long i = 1; i <= (long long)max_i; i++) {
-        // i=1 => p=3, i=2 => p=5, etc.
-        if (TEST_BIT(bitset, i)) { 
-            unsigned long long p = (i << 1) + 1ULL; 
-            unsigned long long start = (p * p) >> 1; // index of p^2
-            // Mark multiples of p as composite
-            for (unsigned long long multiple = start; multiple < size; multiple += p) {
-                CLEAR_BIT(bitset, multiple);
+    std::vector<unsigned long long> base;
+    {
+        unsigned long long bsize = (limit >> 1) + 1;
+        std::vector<unsigned long long> small((bsize + 63) / 64, 0xFFFFFFFFFFFFFFFFULL);
+        for (unsigned long long i = 1; (2 * i + 1) * (2 * i + 1) <= limit; i++) {
+            if (TEST_BIT(small, i)) {
+                unsigned long long p = (i << 1) + 1ULL;
+                for (unsigned long long m = (p * p) >> 1; m < bsize; m += p) {
+                    CLEAR_BIT(small, m);
+                }
             }
         }
+        for (unsigned long long i = 1; i < bsize; i++) {
+            if (TEST_BIT(small, i)) base.push_back((i << 1) + 1ULL);
+        }
     }
 
-    // Collect primes from the bitset
+    // Cache-line-aligned bitmap
+    std::vector<unsigned long long> storage(words + LINE_WORDS);
+    unsigned long long* bitset = storage.data();
+    while ((reinterpret_cast<std::uintptr_t>(bitset) & 63) != 0) bitset++;
+
+    std::size_t lines = (words + LINE_WORDS - 1) / LINE_WORDS;
+    std::vector<std::size_t> offset(omp_get_max_threads() + 1, 0);
     std::vector<unsigned long long> primes;
-    primes.reserve(size / 10); // rough guess for capacity
-    primes.push_back(2ULL);    // add the even prime
 
-    for (unsigned long long i = 1; i < size; i++) {
-        if (TEST_BIT(bitset, i)) {
-            unsigned long long p = (i << 1) + 1ULL;
-            if (p <= n) {
-                primes.push_back(p);
-            } else {
-                break;
+    #pragma omp parallel
+    {
+        int t = omp_get_thread_num();
+        int nt = omp_get_num_threads();
+        std::size_t w0 = std::min(words, lines * t / nt * LINE_WORDS);
+        std::size_t w1 = std::min(words, lines * (t + 1) / nt * LINE_WORDS);
+
+        // Sieve this thread's block chunk by chunk
+        for (std::size_t c0 = w0; c0 < w1; c0 += CHUNK_WORDS) {
+            std::size_t c1 = std::min(c0 + CHUNK_WORDS, w1);
+            std::fill(bitset + c0, bitset + c1, 0xFFFFFFFFFFFFFFFFULL);
+            unsigned long long lo = (unsigned long long)c0 * 64;
+            unsigned long long hi = std::min<unsigned long long>((unsigned long long)c1 * 64, nbits);
+            for (unsigned long long p : base) {
+                unsigned long long start = (p * p) >> 1; // index of p^2
+                if (start >= hi) break;
+                if (start < lo) start += (lo - start + p - 1) / p * p;
+                for (unsigned long long multiple = start; multiple < hi; multiple += p) {
+                    CLEAR_BIT(bitset, multiple);
+                }
+            }
+        }
+        if (w0 == 0 && w1 > 0) {
+            CLEAR_BIT(bitset, 0);  // index 0 corresponds to number 1 (not prime)
+        }
+        if (w1 == words && w1 > w0 && (nbits & 63)) {
+            bitset[words - 1] &= (1ULL << (nbits & 63)) - 1;
+        }
+
+        // Count, find this block's slot, then extract into it
+        std::size_t count = 0;
+        for (std::size_t w = w0; w < w1; w++) {
+            count += __builtin_popcountll(bitset[w]);
+        }
+        offset[t + 1] = count;
+        #pragma omp barrier
+        #pragma omp single
+        {
+            for (int k = 0; k < nt; k++) offset[k + 1] += offset[k];
+            primes.resize(1 + offset[nt]);
+            primes[0] = 2ULL;                   // the even prime
+        }
+        unsigned long long* out = primes.data() + 1 + offset[t];
+        for (std::size_t w = w0; w < w1; w++) {
+            for (unsigned long long x = bitset[w]; x; x &= x - 1) {
+                *out++ = ((((unsigned long long)w << 6) + __builtin_ctzll(x)) << 1) + 1ULL;
             }
         }
     }